@@ -0,0 +1,129 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Micro-benchmark harness. Every case is warmed up, then timed over a number of
+// repetitions; each repetition runs the case often enough to last min_sample_ns, and
+// its sample is the time per run. Results are printed as a table and written as JSON.
+
+/// --- optimization barriers ---
+template<typename T> void keep(T const& v) noexcept { asm volatile("" : : "r"(&v) : "memory"); }
+inline void clobber() noexcept { asm volatile("" : : : "memory"); }
+/// --- end optimization barriers ---
+
+struct bench_opts final {
+    size_t      warmup        = 3;
+    size_t      reps          = 15;
+    double      min_sample_ns = 2e6;
+    std::string filter; // only cases whose name contains this run
+    std::string json;   // output file, none if empty
+
+    // Recognizes --warmup N, --reps N, --min-ms X, --filter S and --json FILE.
+    static bench_opts parse(int argc, char** argv) {
+        bench_opts o;
+        for (int i = 1; i < argc; i++) {
+            std::string_view a = argv[i];
+            auto next = [&]() -> char const* {
+                if (i + 1 >= argc) { std::cerr << "missing value for " << a << '\n'; std::exit(2); }
+                return argv[++i];
+            };
+            if      (a == "--warmup") o.warmup        = std::strtoul(next(), nullptr, 10);
+            else if (a == "--reps"  ) o.reps          = std::max(1UL, std::strtoul(next(), nullptr, 10));
+            else if (a == "--min-ms") o.min_sample_ns = std::strtod(next(), nullptr) * 1e6;
+            else if (a == "--filter") o.filter        = next();
+            else if (a == "--json"  ) o.json          = next();
+            else { std::cerr << "unknown option " << a << '\n'; std::exit(2); }
+        }
+        return o;
+    }
+};
+
+struct bench_result final {
+    std::string         name;
+    size_t              bytes {}; // moved per run
+    size_t              flops {}; // per run
+    size_t              iters {}; // runs per sample
+    std::vector<double> samples;  // ns per run, sorted
+
+    [[nodiscard]] double pct(double p) const noexcept {
+        double pos = p * double(samples.size() - 1);
+        auto   lo  = size_t(pos);
+        size_t hi  = std::min(lo + 1, samples.size() - 1);
+        return samples[lo] + ((pos - double(lo)) * (samples[hi] - samples[lo]));
+    }
+    [[nodiscard]] double median() const noexcept { return pct(0.5); }
+    [[nodiscard]] double gbps  () const noexcept { return double(bytes) / median(); }
+    [[nodiscard]] double gflops() const noexcept { return double(flops) / median(); }
+};
+
+struct bench_runner final {
+    bench_opts                opts;
+    std::vector<bench_result> results;
+
+    // Times fn(), which moves the given bytes and does the given flops per run.
+    template<typename F>
+    void run(std::string const& name, size_t bytes, size_t flops, F&& fn) {
+        if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos) return;
+        for (size_t i = 0; i < opts.warmup; i++) { fn(); clobber(); }
+
+        size_t iters = 1;
+        for (;;) {
+            double t = time(iters, fn);
+            if (t >= opts.min_sample_ns || iters >= (size_t {1} << 30)) break;
+            iters = t <= 0 ? iters * 16 : std::max(iters * 2, size_t(iters * opts.min_sample_ns / t));
+        }
+
+        bench_result r {.name = name, .bytes = bytes, .flops = flops, .iters = iters, .samples = {}};
+        for (size_t i = 0; i < opts.reps; i++) r.samples.push_back(time(iters, fn) / double(iters));
+        std::sort(r.samples.begin(), r.samples.end());
+        print(r);
+        results.push_back(std::move(r));
+    }
+
+    static void print_header() {
+        std::cout << std::left << std::setw(32) << "case" << std::right
+                  << std::setw(12) << "median ns" << std::setw(12) << "p10 ns"
+                  << std::setw(12) << "p90 ns" << std::setw(10) << "GB/s"
+                  << std::setw(10) << "GFLOP/s" << '\n';
+    }
+    static void print(bench_result const& r) {
+        std::cout << std::left << std::setw(32) << r.name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(12) << r.median()
+                  << std::setw(12) << r.pct(0.1) << std::setw(12) << r.pct(0.9)
+                  << std::setprecision(2) << std::setw(10) << r.gbps()
+                  << std::setw(10) << r.gflops() << '\n';
+    }
+
+    void write_json(std::ostream& o) const {
+        o << "{\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            auto const& r = results[i];
+            o << (i ? ",\n" : "\n") << std::setprecision(6)
+              << "    {\"name\": \"" << r.name << "\", \"bytes\": " << r.bytes
+              << ", \"flops\": " << r.flops << ", \"iters\": " << r.iters
+              << ", \"median_ns\": " << r.median() << ", \"p10_ns\": " << r.pct(0.1)
+              << ", \"p90_ns\": " << r.pct(0.9) << ", \"gbps\": " << r.gbps()
+              << ", \"gflops\": " << r.gflops() << ", \"samples_ns\": [";
+            for (size_t j = 0; j < r.samples.size(); j++) o << (j ? ", " : "") << r.samples[j];
+            o << "]}";
+        }
+        o << "\n  ]\n}\n";
+    }
+
+private:
+    template<typename F>
+    static double time(size_t iters, F& fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iters; i++) { fn(); clobber(); }
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+};
@@ -0,0 +1,103 @@
+#include "bench_json.hxx"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+// Compares two matrix-bench JSON files case by case.
+// A case has changed when the Mann-Whitney U test over the per-repetition samples rejects
+// equal distributions at level alpha and the medians differ by more than threshold.
+// The exit status is 1 when any case regressed, so this can gate a change.
+
+struct case_samples final {
+    double              median;
+    std::vector<double> samples;
+};
+
+static std::map<std::string, case_samples> load(char const* path) {
+    std::ifstream f(path);
+    if (!f) throw std::runtime_error(std::string("cannot read ") + path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    std::string text = ss.str();
+    json_value  root = json_parser {.s = text}.parse();
+
+    std::map<std::string, case_samples> cases;
+    for (auto const& b : root["benchmarks"].arr()) {
+        case_samples c {.median = b["median_ns"].num(), .samples = {}};
+        for (auto const& s : b["samples_ns"].arr()) c.samples.push_back(s.num());
+        cases.emplace(b["name"].str(), std::move(c));
+    }
+    return cases;
+}
+
+// Two-sided p-value of the Mann-Whitney U test, normal approximation with tie correction.
+static double mann_whitney_p(std::vector<double> const& a, std::vector<double> const& b) {
+    size_t n1 = a.size(), n2 = b.size(), n = n1 + n2;
+    if (n1 == 0 || n2 == 0) return 1;
+    std::vector<std::pair<double, bool>> all; // value, is from a
+    for (double x : a) all.emplace_back(x, true);
+    for (double x : b) all.emplace_back(x, false);
+    std::sort(all.begin(), all.end());
+
+    double rank_a = 0, ties = 0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && all[j].first == all[i].first) j++;
+        double rank = double(i + j + 1) / 2, t = double(j - i);
+        ties += (t * t * t) - t;
+        for (size_t k = i; k < j; k++) if (all[k].second) rank_a += rank;
+        i = j;
+    }
+    double u   = rank_a - (double(n1) * double(n1 + 1) / 2);
+    double mu  = double(n1) * double(n2) / 2;
+    double var = (double(n1) * double(n2) / 12) * (double(n + 1) - (ties / double(n * (n - 1))));
+    if (var <= 0) return 1;
+    double z = (std::abs(u - mu) - 0.5) / std::sqrt(var); // with continuity correction
+    return std::erfc(std::max(z, 0.0) / std::sqrt(2.0));
+}
+
+int main(int argc, char** argv) {
+    double alpha = 0.01, threshold = 0.05;
+    std::vector<char const*> files;
+    for (int i = 1; i < argc; i++) {
+        std::string_view a = argv[i];
+        if      (a == "--alpha"     && i + 1 < argc) alpha     = std::strtod(argv[++i], nullptr);
+        else if (a == "--threshold" && i + 1 < argc) threshold = std::strtod(argv[++i], nullptr);
+        else files.push_back(argv[i]);
+    }
+    if (files.size() != 2) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--alpha P] [--threshold FRACTION] BASELINE.json NEW.json\n";
+        return 2;
+    }
+
+    std::map<std::string, case_samples> base, next;
+    try { base = load(files[0]); next = load(files[1]); }
+    catch (std::exception const& e) { std::cerr << e.what() << '\n'; return 2; }
+
+    size_t regressed = 0, improved = 0;
+    std::cout << std::left << std::setw(32) << "case" << std::right << std::setw(14) << "base ns"
+              << std::setw(14) << "new ns" << std::setw(10) << "speedup" << std::setw(10) << "p"
+              << "  verdict\n";
+    for (auto const& [name, b] : base) {
+        auto it = next.find(name);
+        if (it == next.end()) { std::cout << std::left << std::setw(32) << name << "  missing\n"; continue; }
+        auto const& n = it->second;
+        double speedup = b.median / n.median, p = mann_whitney_p(b.samples, n.samples);
+        char const* verdict = "same";
+        if (p < alpha && speedup < 1 / (1 + threshold)) { verdict = "SLOWER"; regressed++; }
+        if (p < alpha && speedup > 1 + threshold)       { verdict = "faster"; improved++;  }
+        std::cout << std::left << std::setw(32) << name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(14) << b.median << std::setw(14) << n.median
+                  << std::setprecision(3) << std::setw(10) << speedup << std::setprecision(4)
+                  << std::setw(10) << p << "  " << verdict << '\n';
+    }
+    for (auto const& [name, n] : next)
+        if (!base.contains(name)) std::cout << std::left << std::setw(32) << name << "  new\n";
+    std::cout << improved << " faster, " << regressed << " slower\n";
+    return regressed ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+// Just enough of a JSON reader for benchmark result files.
+
+struct json_error : std::runtime_error {
+    json_error(std::string const& what, size_t pos)
+        : std::runtime_error(what + " at offset " + std::to_string(pos)) {}
+};
+
+struct json_value final {
+    using array  = std::vector<json_value>;
+    using object = std::map<std::string, json_value>;
+    std::variant<std::nullptr_t, bool, double, std::string,
+                 std::shared_ptr<array>, std::shared_ptr<object>> v;
+
+    [[nodiscard]] double             num() const { return get<double>(); }
+    [[nodiscard]] std::string const& str() const { return get<std::string>(); }
+    [[nodiscard]] array  const&      arr() const { return *get<std::shared_ptr<array >>(); }
+    [[nodiscard]] object const&      obj() const { return *get<std::shared_ptr<object>>(); }
+    [[nodiscard]] json_value const& operator [](std::string const& k) const {
+        auto it = obj().find(k);
+        if (it == obj().end()) throw std::runtime_error("missing JSON key " + k);
+        return it->second;
+    }
+
+private:
+    template<typename U> U const& get() const {
+        if (auto* p = std::get_if<U>(&v)) return *p;
+        throw std::runtime_error("unexpected JSON value type");
+    }
+};
+
+struct json_parser final {
+    std::string const& s;
+    size_t             pos {};
+
+    [[nodiscard]] json_value parse() {
+        json_value v = value();
+        ws();
+        if (pos != s.size()) throw json_error("trailing characters", pos);
+        return v;
+    }
+
+private:
+    void ws() { while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) pos++; }
+    void expect(char c) {
+        ws();
+        if (pos >= s.size() || s[pos] != c) throw json_error(std::string("expected ") + c, pos);
+        pos++;
+    }
+    bool accept(char c) {
+        ws();
+        if (pos < s.size() && s[pos] == c) { pos++; return true; }
+        return false;
+    }
+    bool keyword(char const* w) {
+        size_t n = std::char_traits<char>::length(w);
+        if (s.compare(pos, n, w) != 0) return false;
+        pos += n;
+        return true;
+    }
+
+    json_value value() {
+        ws();
+        if (pos >= s.size()) throw json_error("unexpected end", pos);
+        char c = s[pos];
+        if (c == '{') return {std::make_shared<json_value::object>(object())};
+        if (c == '[') return {std::make_shared<json_value::array >(array ())};
+        if (c == '"') return {string()};
+        if (keyword("true" )) return {true};
+        if (keyword("false")) return {false};
+        if (keyword("null" )) return {nullptr};
+        char const* begin = s.c_str() + pos;
+        char*       end   = nullptr;
+        double      d     = std::strtod(begin, &end);
+        if (end == begin) throw json_error("bad value", pos);
+        pos += size_t(end - begin);
+        return {d};
+    }
+    json_value::object object() {
+        json_value::object o;
+        expect('{');
+        if (accept('}')) return o;
+        do {
+            ws();
+            std::string k = string();
+            expect(':');
+            o.emplace(std::move(k), value());
+        } while (accept(','));
+        expect('}');
+        return o;
+    }
+    json_value::array array() {
+        json_value::array a;
+        expect('[');
+        if (accept(']')) return a;
+        do a.push_back(value()); while (accept(','));
+        expect(']');
+        return a;
+    }
+    std::string string() {
+        expect('"');
+        std::string r;
+        while (pos < s.size() && s[pos] != '"') {
+            char c = s[pos++];
+            if (c == '\\') {
+                if (pos >= s.size()) break;
+                c = s[pos++];
+                switch (c) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u': throw json_error("unicode escapes are not supported", pos);
+                default:  break;
+                }
+            }
+            r += c;
+        }
+        expect('"');
+        return r;
+    }
+};
@@ -0,0 +1,57 @@
+#include "bench.hxx"
+#include "owned_mat.hxx"
+#include <fstream>
+#include <sstream>
+
+// Basic vec and mat operations over square matrices of both storage orders.
+
+template<mat_maj maj> constexpr char const* maj_name = maj == mat_maj::row ? "row" : "col";
+
+template<typename T, mat_maj maj>
+static owned_mat<T, maj> filled(size_t n, T seed) {
+    owned_mat<T, maj> m(n, n, false);
+    T* p = m.base_ptr();
+    for (size_t i = 0; i < n * n; i++) p[i] = seed + T(i % 97);
+    return m;
+}
+
+template<typename T, mat_maj maj>
+static void bench_mat(bench_runner& b, size_t n) {
+    std::string sfx = std::string("/") + maj_name<maj> + "/" + std::to_string(n);
+    size_t      sz  = n * n * sizeof(T);
+    auto a = filled<T, maj>(n, T(1));
+    auto c = filled<T, maj>(n, T(2));
+    auto d = a, e = a; // e stays equal to a
+
+    b.run("construct" + sfx, sz, 0, [&] { owned_mat<T, maj> m(n, n); keep(m); });
+    b.run("copy"      + sfx, 2 * sz, 0, [&] { owned_mat<T, maj> m(a); keep(m); });
+    b.run("assign"    + sfx, 2 * sz, 0, [&] { d = a; keep(d); });
+    b.run("add"       + sfx, 3 * sz, n * n, [&] { auto m = a + c; keep(m); });
+    b.run("add_assign"+ sfx, 3 * sz, n * n, [&] { d += c; keep(d); });
+    b.run("compare"   + sfx, 2 * sz, 0, [&] { bool eq = a == e; keep(eq); });
+    b.run("transpose" + sfx, 2 * sz, 0, [&] {
+        for (size_t i = 0; i < n; i++) d.row(i).copy_from_nocklen(a.col(i));
+        keep(d);
+    });
+    b.run("row_dot"   + sfx, 2 * n * sizeof(T), 2 * n, [&] { T s = a[1] * c[2]; keep(s); });
+    b.run("col_dot"   + sfx, 2 * n * sizeof(T), 2 * n,
+          [&] { T s = a.col(1) * c.col(2); keep(s); });
+    if (n <= 256) {
+        std::ostringstream s;
+        b.run("print" + sfx, sz, 0, [&] { s.str({}); s << a; keep(s); });
+    }
+}
+
+int main(int argc, char** argv) {
+    bench_runner b {.opts = bench_opts::parse(argc, argv), .results = {}};
+    bench_runner::print_header();
+    for (size_t n : {16, 64, 256, 1024}) {
+        bench_mat<double, mat_maj::row>(b, n);
+        bench_mat<double, mat_maj::col>(b, n);
+    }
+    if (!b.opts.json.empty()) {
+        std::ofstream f(b.opts.json);
+        b.write_json(f);
+        if (!f) { std::cerr << "cannot write " << b.opts.json << '\n'; return 1; }
+    }
+}
@@ -0,0 +1,63 @@
+#include "batch.hxx"
+#include "gemv.hxx"
+#include "qr.hxx"
+#include "roofline.hxx"
+#include "sparse.hxx"
+#include <fstream>
+#include <string_view>
+
+// Runs representative library workloads with per-site counters on and places them
+// under the roofline of this machine. --json FILE also dumps the raw site totals.
+
+static csr_mat<double> poisson(size_t k) {
+    std::vector<coo_entry<double>> es;
+    for (size_t i = 0; i < k; i++) for (size_t j = 0; j < k; j++) {
+        size_t r = (i * k) + j;
+        es.push_back({r, r, 4.0});
+        if (i > 0)     es.push_back({r, r - k, -1.0});
+        if (i + 1 < k) es.push_back({r, r + k, -1.0});
+        if (j > 0)     es.push_back({r, r - 1, -1.0});
+        if (j + 1 < k) es.push_back({r, r + 1, -1.0});
+    }
+    return csr_mat<double>::from_entries(k * k, k * k, es);
+}
+
+template<typename M> static void fill(M& m) {
+    double* p = m.base_ptr();
+    for (size_t i = 0; i < m.n_rows() * m.n_cols(); i++) p[i] = 1.0 + double(i % 13);
+}
+
+int main(int argc, char** argv) {
+    char const* json = nullptr;
+    for (int i = 1; i + 1 < argc; i++) if (std::string_view(argv[i]) == "--json") json = argv[++i];
+
+    std::cout << "probing machine...\n";
+    roofline_machine m = roofline_probe();
+    perf_registry::get().reset();
+
+    owned_row_mat<double> a(2048, 2048, false), b(2048, 2048, false);
+    fill(a); fill(b);
+    for (int r = 0; r < 5; r++) { auto c = a + b; }
+
+    owned_vec<double> x(2048), y(2048);
+    for (int r = 0; r < 20; r++) gemv(1.0, a.as_const(), x.as_const(), 0.0, y.as_ref());
+
+    auto s = poisson(500);
+    owned_vec<double> sx(s.n_cols()), sy(s.n_rows());
+    for (int r = 0; r < 20; r++) s.mul_vec(sx.as_const(), sy.as_ref());
+
+    size_t const nb = 20000;
+    std::vector<double> ba(nb * 64, 1.0), bb(nb * 64, 2.0), bc(nb * 64);
+    for (int r = 0; r < 5; r++) {
+        gemm_batch<double, mat_maj::row>({ba.data(), nb, 8, 8, 64}, {bb.data(), nb, 8, 8, 64},
+                                         {bc.data(), nb, 8, 8, 64});
+    }
+
+    owned_col_mat<double> q(4000, 200, false);
+    fill(q);
+    for (size_t j = 0; j < 200; j++) q.col_ptr(j)[j] += 100;
+    qr_fact<double> f(q.as_const());
+
+    roofline_report(std::cout, m, perf_registry::get().snapshot());
+    if (json) { std::ofstream o(json); perf_registry::get().dump_json(o); }
+}
@@ -0,0 +1,32 @@
+#include "autotune.hxx"
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+// Tunes the library's kernels on this machine and stores the result where the library
+// loads it from at startup. --n N sizes the test problems, --reps R the timed runs,
+// --out FILE overrides the file and --dry-run only prints the parameters.
+
+int main(int argc, char** argv) {
+    autotune_opts o {.log = &std::cout};
+    std::string   out = tune_file_path();
+    bool          dry = false;
+    for (int i = 1; i < argc; i++) {
+        std::string_view a = argv[i];
+        if      (a == "--n"    && i + 1 < argc) o.n    = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--reps" && i + 1 < argc) o.reps = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--out"  && i + 1 < argc) out    = argv[++i];
+        else if (a == "--dry-run") dry = true;
+        else {
+            std::cerr << "usage: matrix-tune [--n N] [--reps R] [--out FILE] [--dry-run]\n";
+            return 2;
+        }
+    }
+
+    tune_params p = autotune(o);
+    std::cout << '\n';
+    write_tune_file(std::cout, p);
+    if (dry) return 0;
+    if (!save_tune_file(p, out)) { std::cerr << "cannot write " << out << '\n'; return 1; }
+    std::cout << "saved to " << out << '\n';
+}
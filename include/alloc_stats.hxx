@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+// Memory accounting for owned_mat and owned_vec buffers. With MATRIX_ALLOC_STATS defined,
+// every buffer records its size and the tag in effect where it was allocated, and the
+// totals below follow allocations and frees; without it the bookkeeping member is empty
+// and every hook is a no-op. Tags are set for a scope with alloc_tag_scope and name the
+// caller, e.g. alloc_tag_scope t("solver") before building a solver's work matrices.
+
+/// --- usage ---
+struct alloc_usage final {
+    size_t live_bytes {};
+    size_t peak_bytes {};
+    size_t allocs     {};
+    size_t frees      {};
+};
+
+struct alloc_snapshot final {
+    alloc_usage                        total;
+    std::map<std::string, alloc_usage> tags;
+};
+
+struct alloc_registry final {
+    [[nodiscard]] static alloc_registry& get() { static alloc_registry r; return r; }
+
+    void on_alloc(char const* tag, size_t bytes) {
+        std::lock_guard lk(mtx);
+        add(total, bytes);
+        add(tags[tag], bytes);
+    }
+    void on_free(char const* tag, size_t bytes) {
+        std::lock_guard lk(mtx);
+        sub(total, bytes);
+        if (auto it = tags.find(tag); it != tags.end()) sub(it->second, bytes);
+    }
+
+    [[nodiscard]] alloc_snapshot snapshot() const {
+        std::lock_guard lk(mtx);
+        return {total, tags};
+    }
+    // Lowers every peak to the current live size, e.g. after a metrics scrape.
+    void reset_peaks() {
+        std::lock_guard lk(mtx);
+        total.peak_bytes = total.live_bytes;
+        for (auto& [_, u] : tags) u.peak_bytes = u.live_bytes;
+    }
+
+private:
+    mutable std::mutex                 mtx;
+    alloc_usage                        total;
+    std::map<std::string, alloc_usage> tags;
+
+    static void add(alloc_usage& u, size_t bytes) noexcept {
+        u.live_bytes += bytes;
+        u.peak_bytes  = std::max(u.peak_bytes, u.live_bytes);
+        u.allocs++;
+    }
+    static void sub(alloc_usage& u, size_t bytes) noexcept {
+        u.live_bytes -= std::min(u.live_bytes, bytes);
+        u.frees++;
+    }
+};
+/// --- end usage ---
+
+/// --- tags ---
+inline char const*& alloc_tag_current() noexcept {
+    thread_local char const* tag = "untagged";
+    return tag;
+}
+
+// Attributes allocations made by this thread during its lifetime to tag, a string literal.
+// par_invoke carries the tag over to its workers.
+struct alloc_tag_scope final {
+    explicit alloc_tag_scope(char const* tag) noexcept : prev(alloc_tag_current())
+        { alloc_tag_current() = tag; }
+    ~alloc_tag_scope() { alloc_tag_current() = prev; }
+    alloc_tag_scope(alloc_tag_scope const&) = delete;
+    alloc_tag_scope& operator =(alloc_tag_scope const&) = delete;
+private:
+    char const* prev;
+};
+/// --- end tags ---
+
+/// --- per-buffer bookkeeping ---
+template<bool enabled> struct alloc_acct_if;
+template<> struct alloc_acct_if<false> {
+    void on_alloc(size_t) noexcept {}
+    void on_free() noexcept {}
+    void take(alloc_acct_if&) noexcept {}
+};
+template<> struct alloc_acct_if<true> {
+    // Empty buffers are neither allocations nor frees, so the counts stay balanced.
+    void on_alloc(size_t b) {
+        if (!b) return;
+        bytes = b;
+        tag   = alloc_tag_current();
+        alloc_registry::get().on_alloc(tag, bytes);
+    }
+    void on_free() {
+        if (bytes) alloc_registry::get().on_free(tag, bytes);
+        bytes = 0;
+    }
+    // Takes over the buffer accounted by o, e.g. on move.
+    void take(alloc_acct_if& o) noexcept { bytes = std::exchange(o.bytes, 0); tag = o.tag; }
+private:
+    size_t      bytes {};
+    char const* tag   {};
+};
+
+#if defined(MATRIX_ALLOC_STATS)
+using alloc_acct = alloc_acct_if<true>;
+#else
+using alloc_acct = alloc_acct_if<false>;
+#endif
+/// --- end per-buffer bookkeeping ---
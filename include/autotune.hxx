@@ -0,0 +1,159 @@
+#pragma once
+#include "batch.hxx"
+#include "gemv.hxx"
+#include "qr.hxx"
+#include "sparse.hxx"
+#include "spgemm.hxx"
+#include "tune.hxx"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <ostream>
+#include <system_error>
+
+// Measures the kernels on this machine under candidate tune_params (tune.hxx) and keeps the
+// fastest. Every parameter is swept in turn with the others held at their best so far,
+// blocks first, then parallel grains. Tuning takes seconds to minutes depending on
+// autotune_opts::n; save_tune_file stores the result where later runs load it from.
+
+struct autotune_opts final {
+    size_t        n    = 2048;    // size of the test problems, in rows
+    size_t        reps = 5;       // timed runs per candidate, the fastest counts
+    std::ostream* log  = nullptr; // one line per candidate when set
+};
+
+/// --- timing ---
+// Fastest of reps runs of f after one untimed run, in nanoseconds.
+template<typename F>
+[[nodiscard]] double autotune_time(size_t reps, F&& f) {
+    f();
+    double best = 0;
+    for (size_t r = 0; r < std::max<size_t>(reps, 1); r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0)
+                        .count();
+        if (r == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+// Sets p.*field to every candidate, times work under each and leaves the fastest in p.
+template<typename F>
+void autotune_sweep(tune_params& p, size_t tune_params::* field, char const* name,
+                    std::initializer_list<size_t> cands, autotune_opts const& o, F&& work) {
+    size_t best = p.*field;
+    double best_ns = -1;
+    for (size_t c : cands) {
+        p.*field = c;
+        set_tuned(p);
+        double ns = autotune_time(o.reps, work);
+        if (o.log) *o.log << name << ' ' << c << ": " << ns / 1e6 << " ms\n";
+        if (best_ns < 0 || ns < best_ns) { best = c; best_ns = ns; }
+    }
+    p.*field = best;
+    set_tuned(p);
+}
+/// --- end timing ---
+
+/// --- workloads ---
+template<typename M>
+void autotune_fill(M& m) {
+    auto* p = m.base_ptr();
+    for (size_t i = 0; i < m.n_rows() * m.n_cols(); i++) p[i] = 1.0 + double(i % 13);
+}
+
+// 5-point Laplacian on a k x k grid.
+[[nodiscard]] inline csr_mat<double> autotune_poisson(size_t k) {
+    std::vector<coo_entry<double>> es;
+    for (size_t i = 0; i < k; i++) for (size_t j = 0; j < k; j++) {
+        size_t r = (i * k) + j;
+        es.push_back({r, r, 4.0});
+        if (i > 0)     es.push_back({r, r - k, -1.0});
+        if (i + 1 < k) es.push_back({r, r + k, -1.0});
+        if (j > 0)     es.push_back({r, r - 1, -1.0});
+        if (j + 1 < k) es.push_back({r, r + 1, -1.0});
+    }
+    return csr_mat<double>::from_entries(k * k, k * k, es);
+}
+/// --- end workloads ---
+
+// Tunes the parameters of this process, starting from the current ones, and returns them.
+[[nodiscard]] inline tune_params autotune(autotune_opts const& o = {}) {
+    tune_params p = tuned();
+    size_t n = std::max<size_t>(o.n, 64);
+
+    {   // gemv blocks: long rows for the row-major kernel, long columns for the column-major
+        owned_row_mat<double> ar(n / 4, 4 * n, false);
+        owned_col_mat<double> ac(4 * n, n / 4, false);
+        autotune_fill(ar); autotune_fill(ac);
+        owned_vec<double> x(4 * n), y(4 * n);
+        autotune_sweep(p, &tune_params::gemv_block, "gemv_block",
+                       {256, 512, 1024, 2048, 4096, 8192}, o, [&] {
+            gemv(1.0, ar.as_const(), x.as_const(), 0.0, y.as_ref().slice_nocklen(0, n / 4));
+            gemv(1.0, ac.as_const(), x.as_const().slice_nocklen(0, n / 4), 0.0, y.as_ref());
+        });
+    }
+    {
+        owned_col_mat<double> a(n, n / 8, false);
+        autotune_fill(a);
+        for (size_t j = 0; j < n / 8; j++) a.col_ptr(j)[j] += double(n);
+        autotune_sweep(p, &tune_params::qr_block, "qr_block",
+                       {8, 16, 32, 48, 64, 96, 128}, o, [&] {
+            qr_fact<double> f(a.as_const());
+        });
+    }
+    {   // grains decide how small a problem still gets more threads, so sizes are mixed
+        std::vector<owned_row_mat<double>> as;
+        for (size_t m = n / 32; m <= n / 2; m *= 4) {
+            as.emplace_back(m, m, false);
+            autotune_fill(as.back());
+        }
+        owned_vec<double> x(n), y(n);
+        autotune_sweep(p, &tune_params::dense_grain, "dense_grain",
+                       {1 << 12, 1 << 13, 1 << 14, 1 << 15, 1 << 16, 1 << 17, 1 << 18}, o, [&] {
+            for (auto const& a : as) {
+                gemv(1.0, a.as_const(), x.as_const().slice_nocklen(0, a.n_cols()), 0.0,
+                     y.as_ref().slice_nocklen(0, a.n_rows()));
+            }
+        });
+    }
+    {
+        std::vector<csr_mat<double>> ss;
+        for (size_t k = n / 32; k <= n / 2; k *= 4) ss.push_back(autotune_poisson(k));
+        owned_vec<double> x(n * n / 4), y(n * n / 4);
+        autotune_sweep(p, &tune_params::sparse_grain, "sparse_grain",
+                       {1 << 11, 1 << 12, 1 << 13, 1 << 14, 1 << 15, 1 << 16, 1 << 17}, o, [&] {
+            for (auto const& s : ss) {
+                s.mul_vec_nocklen(x.as_const().slice_nocklen(0, s.n_cols()),
+                                  y.as_ref().slice_nocklen(0, s.n_rows()));
+            }
+            (void)spgemm(ss.front(), ss.front());
+        });
+    }
+    {
+        size_t const cnt = 8 * n;
+        std::vector<double> ba(cnt * 16, 1.0), bb(cnt * 16, 2.0), bc(cnt * 16);
+        autotune_sweep(p, &tune_params::batch_grain, "batch_grain",
+                       {1 << 13, 1 << 14, 1 << 15, 1 << 16, 1 << 17, 1 << 18, 1 << 19}, o, [&] {
+            for (size_t c = cnt / 64; c <= cnt; c *= 8) {
+                gemm_batch<double, mat_maj::row>({ba.data(), c, 4, 4, 16},
+                                                 {bb.data(), c, 4, 4, 16},
+                                                 {bc.data(), c, 4, 4, 16});
+            }
+        });
+    }
+    return p;
+}
+
+// Writes p to path, tune_file_path() by default, creating its directory. False on failure.
+inline bool save_tune_file(tune_params const& p, std::string path = tune_file_path()) {
+    if (path.empty()) return false;
+    std::error_code ec;
+    auto dir = std::filesystem::path(path).parent_path();
+    if (!dir.empty()) std::filesystem::create_directories(dir, ec);
+    std::ofstream f(path);
+    write_tune_file(f, p);
+    return bool(f);
+}
@@ -0,0 +1,191 @@
+#pragma once
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include "par.hxx"
+#include "tune.hxx"
+#include <functional>
+#include <limits>
+
+// Reductions of every row or every column of a matrix into an owned_vec.
+// Reducing along majvecs (rows of a row-major matrix) folds each contiguous majvec with
+// lane_fold. Reducing across them (columns of a row-major matrix) never strides. Instead,
+// whole majvecs are folded element-wise into the output, which vectorizes. Threads take
+// disjoint ranges of the output when it is long enough, or always when par_reproducible()
+// is set, which keeps results independent of the thread count. Otherwise each thread takes
+// a range of majvecs into a private vector, and the vectors are combined in order.
+
+struct axis_kernel final {
+    // out[i] := init op (fold of majvec i) for every majvec i.
+    template<typename R, typename T, mat_maj maj, typename Op>
+    static void along(mat<T, maj> a, R init, Op& op, R* out) {
+        size_t n = a.n_min();
+        par_for(a.n_maj(), std::max<size_t>(1, tuned().dense_grain / (n + 1)),
+                [&](size_t i0, size_t i1) {
+            for (size_t i = i0; i < i1; i++) {
+                T* p = a.base_ptr() + (i * n);
+                out[i] = n ? op(init, lane_fold<R>(n, op, [&](size_t k) { return R(p[k]); }))
+                           : init;
+            }
+        });
+    }
+
+    // out[k] := init op a_0[k] op a_1[k] ... over majvecs a_i, for every k.
+    template<typename R, typename T, mat_maj maj, typename Op>
+    static void across(mat<T, maj> a, R init, Op& op, R* out) {
+        size_t m = a.n_maj(), n = a.n_min();
+        T* base = a.base_ptr();
+        auto fold = [&](size_t i0, size_t i1, size_t k0, size_t k1, R* acc) {
+            for (size_t i = i0; i < i1; i++) {
+                T* p = base + (i * n);
+                for (size_t k = k0; k < k1; k++) acc[k] = op(acc[k], R(p[k]));
+            }
+        };
+        std::fill(out, out + n, init);
+        size_t parts = std::clamp<size_t>(m * n / std::max<size_t>(tuned().dense_grain, 1), 1,
+                                          par_threads());
+        if (parts == 1 || n >= parts * min_cols || par_reproducible()) {
+            par_for(n, std::max(min_cols, (n + parts - 1) / parts),
+                    [&](size_t k0, size_t k1) { fold(0, m, k0, k1, out); });
+            return;
+        }
+        parts = std::min(parts, m); // every part starts from its first majvec
+        owned_mat<R, mat_maj::row> acc(parts, n, false);
+        par_invoke(parts, [&](size_t p) {
+            R* ap = acc.row_ptr(p);
+            size_t i0 = m * p / parts, i1 = m * (p + 1) / parts;
+            std::copy(base + (i0 * n), base + ((i0 + 1) * n), ap);
+            fold(i0 + 1, i1, 0, n, ap);
+        });
+        for (size_t p = 0; p < parts; p++) {
+            R const* ap = acc.row_ptr(p);
+            for (size_t k = 0; k < n; k++) out[k] = op(out[k], ap[k]);
+        }
+    }
+
+    // out[i] := index of the first largest element of majvec i.
+    template<typename T, mat_maj maj>
+    static void argmax_along(mat<T, maj> a, size_t* out) {
+        using U = std::remove_const_t<T>;
+        size_t n = a.n_min();
+        auto max = [](U x, U y) { return std::max(x, y); };
+        par_for(a.n_maj(), std::max<size_t>(1, tuned().dense_grain / (n + 1)),
+                [&](size_t i0, size_t i1) {
+            for (size_t i = i0; i < i1; i++) {
+                T* p = a.base_ptr() + (i * n);
+                if (n == 0) { out[i] = 0; continue; }
+                U  best = lane_fold<U>(n, max, [&](size_t k) { return p[k]; });
+                size_t k = 0;
+                while (k + 1 < n && p[k] != best) k++;
+                out[i] = k;
+            }
+        });
+    }
+
+    // out[k] := index of the first majvec holding the largest k-th element.
+    template<typename T, mat_maj maj>
+    static void argmax_across(mat<T, maj> a, size_t* out) {
+        using U = std::remove_const_t<T>;
+        size_t m = a.n_maj(), n = a.n_min();
+        T* base = a.base_ptr();
+        std::fill(out, out + n, size_t {0});
+        if (m == 0) return;
+        owned_vec<U> best(n, false);
+        std::copy(base, base + n, best.ptr());
+        par_for(n, std::max(min_cols, tuned().dense_grain / (m + 1)), [&](size_t k0, size_t k1) {
+            U* b = best.ptr();
+            for (size_t i = 1; i < m; i++) {
+                T* p = base + (i * n);
+                for (size_t k = k0; k < k1; k++) {
+                    bool gt = p[k] > b[k];
+                    b[k]   = gt ? p[k] : b[k];
+                    out[k] = gt ? i : out[k];
+                }
+            }
+        });
+    }
+
+private:
+    // Output elements per thread below which threads take majvecs instead.
+    static constexpr size_t min_cols = 64;
+};
+
+/// --- reductions along an axis ---
+// out[i] := init op a(i, 0) op a(i, 1) ... for every row i.
+template<typename T, mat_maj maj, typename R, typename Op>
+[[nodiscard]] owned_vec<R> reduce_rows(mat<T, maj> a, R init, Op&& op) {
+    MATRIX_PROF_SCOPE("reduce_rows", a.n_rows(), a.n_cols(),
+                      a.n_rows() * a.n_cols() * sizeof(T), a.n_rows() * a.n_cols());
+    owned_vec<R> out(a.n_rows(), false);
+    if constexpr (maj == mat_maj::row) axis_kernel::along (a, init, op, out.ptr());
+    else                               axis_kernel::across(a, init, op, out.ptr());
+    return out;
+}
+// out[j] := init op a(0, j) op a(1, j) ... for every column j.
+template<typename T, mat_maj maj, typename R, typename Op>
+[[nodiscard]] owned_vec<R> reduce_cols(mat<T, maj> a, R init, Op&& op) {
+    MATRIX_PROF_SCOPE("reduce_cols", a.n_rows(), a.n_cols(),
+                      a.n_rows() * a.n_cols() * sizeof(T), a.n_rows() * a.n_cols());
+    owned_vec<R> out(a.n_cols(), false);
+    if constexpr (maj == mat_maj::col) axis_kernel::along (a, init, op, out.ptr());
+    else                               axis_kernel::across(a, init, op, out.ptr());
+    return out;
+}
+
+template<typename T, mat_maj maj, typename U = std::remove_const_t<T>>
+[[nodiscard]] owned_vec<U> row_sums(mat<T, maj> a) { return reduce_rows(a, U {}, std::plus<>()); }
+template<typename T, mat_maj maj, typename U = std::remove_const_t<T>>
+[[nodiscard]] owned_vec<U> col_sums(mat<T, maj> a) { return reduce_cols(a, U {}, std::plus<>()); }
+
+template<typename T, mat_maj maj, typename U = std::remove_const_t<T>>
+    requires std::is_floating_point_v<U>
+[[nodiscard]] owned_vec<U> row_means(mat<T, maj> a)
+    { owned_vec<U> s = row_sums(a); s /= U(a.n_cols()); return s; }
+template<typename T, mat_maj maj, typename U = std::remove_const_t<T>>
+    requires std::is_floating_point_v<U>
+[[nodiscard]] owned_vec<U> col_means(mat<T, maj> a)
+    { owned_vec<U> s = col_sums(a); s /= U(a.n_rows()); return s; }
+
+// Extremes of empty rows or columns are the largest (min) or lowest (max) value of U.
+template<typename U>
+inline constexpr U axis_max_init = std::numeric_limits<U>::has_infinity
+                                 ? std::numeric_limits<U>::infinity()
+                                 : std::numeric_limits<U>::max();
+template<typename U>
+inline constexpr U axis_min_init = std::numeric_limits<U>::has_infinity
+                                 ? -std::numeric_limits<U>::infinity()
+                                 : std::numeric_limits<U>::lowest();
+
+template<typename T, mat_maj maj, typename U = std::remove_const_t<T>>
+[[nodiscard]] owned_vec<U> row_mins(mat<T, maj> a)
+    { return reduce_rows(a, axis_max_init<U>, [](U x, U y) { return std::min(x, y); }); }
+template<typename T, mat_maj maj, typename U = std::remove_const_t<T>>
+[[nodiscard]] owned_vec<U> col_mins(mat<T, maj> a)
+    { return reduce_cols(a, axis_max_init<U>, [](U x, U y) { return std::min(x, y); }); }
+template<typename T, mat_maj maj, typename U = std::remove_const_t<T>>
+[[nodiscard]] owned_vec<U> row_maxs(mat<T, maj> a)
+    { return reduce_rows(a, axis_min_init<U>, [](U x, U y) { return std::max(x, y); }); }
+template<typename T, mat_maj maj, typename U = std::remove_const_t<T>>
+[[nodiscard]] owned_vec<U> col_maxs(mat<T, maj> a)
+    { return reduce_cols(a, axis_min_init<U>, [](U x, U y) { return std::max(x, y); }); }
+
+// Column of the first largest element of every row, 0 for empty rows.
+template<typename T, mat_maj maj>
+[[nodiscard]] owned_vec<size_t> row_argmax(mat<T, maj> a) {
+    MATRIX_PROF_SCOPE("row_argmax", a.n_rows(), a.n_cols(),
+                      a.n_rows() * a.n_cols() * sizeof(T), a.n_rows() * a.n_cols());
+    owned_vec<size_t> out(a.n_rows(), false);
+    if constexpr (maj == mat_maj::row) axis_kernel::argmax_along (a, out.ptr());
+    else                               axis_kernel::argmax_across(a, out.ptr());
+    return out;
+}
+// Row of the first largest element of every column, 0 for empty columns.
+template<typename T, mat_maj maj>
+[[nodiscard]] owned_vec<size_t> col_argmax(mat<T, maj> a) {
+    MATRIX_PROF_SCOPE("col_argmax", a.n_rows(), a.n_cols(),
+                      a.n_rows() * a.n_cols() * sizeof(T), a.n_rows() * a.n_cols());
+    owned_vec<size_t> out(a.n_cols(), false);
+    if constexpr (maj == mat_maj::col) axis_kernel::argmax_along (a, out.ptr());
+    else                               axis_kernel::argmax_across(a, out.ptr());
+    return out;
+}
+/// --- end reductions along an axis ---
@@ -0,0 +1,160 @@
+#pragma once
+#include "mat.hxx"
+#include "par.hxx"
+#include "prof.hxx"
+#include "tune.hxx"
+#include <span>
+
+struct batch_len_mismatch : std::runtime_error {
+    batch_len_mismatch(size_t a, size_t b) : std::runtime_error(mk_errmsg(a, b)) {}
+private:
+    static std::string mk_errmsg(size_t a, size_t b) {
+        std::stringstream s;
+        s << "matrix batch length mismatch (" << a << " and " << b << ')';
+        return s.str();
+    }
+};
+
+// Equally sized matrices laid out at a fixed distance from each other, e.g. a 3D array.
+template<typename T, mat_maj maj>
+struct mat_batch final {
+    /// --- fields ---
+    T*     base   {};
+    size_t count  {};
+    size_t rows   {};
+    size_t cols   {};
+    size_t stride {}; // elements from one matrix to the next, at least rows * cols
+    /// --- end fields ---
+
+    [[nodiscard]] mat<T, maj> operator [](size_t i) const noexcept
+        { return mat<T, maj>(base + (i * stride), rows, cols); }
+    [[nodiscard]] operator mat_batch<T const, maj>() const noexcept
+        { return {base, count, rows, cols, stride}; }
+};
+
+// C_i := A_i B_i over batches of small matrices. Square products of the common sizes
+// (2, 3, 4, 8, 16, 32) run kernels whose loop bounds are compile-time constants, so they
+// are fully unrolled and vectorized across the output row; other shapes run a generic loop.
+// Column-major operands are multiplied as C^T = B^T A^T on the same row-major kernels.
+struct gemm_batch_kernel final {
+    // Multiply-adds per thread.
+    [[nodiscard]] static size_t par_grain() { return tuned().batch_grain; }
+
+    template<typename T, size_t M, size_t K, size_t N>
+    static void fixed(T const* a, T const* b, T* c) noexcept {
+        for (size_t i = 0; i < M; i++) {
+            T row[N] {};
+            for (size_t k = 0; k < K; k++) {
+                T aik = a[(i * K) + k];
+                for (size_t j = 0; j < N; j++) row[j] += aik * b[(k * N) + j];
+            }
+            for (size_t j = 0; j < N; j++) c[(i * N) + j] = row[j];
+        }
+    }
+    template<typename T>
+    static void generic(size_t m, size_t k, size_t n, T const* a, T const* b, T* c) noexcept {
+        for (size_t i = 0; i < m; i++) {
+            T* ci = c + (i * n);
+            for (size_t j = 0; j < n; j++) ci[j] = T {};
+            for (size_t l = 0; l < k; l++) {
+                T ail = a[(i * k) + l];
+                T const* bl = b + (l * n);
+                for (size_t j = 0; j < n; j++) ci[j] += ail * bl[j];
+            }
+        }
+    }
+
+    // Row-major product of count m x k and k x n matrices found through the getters.
+    template<typename T, typename GA, typename GB, typename GC>
+    static void run(size_t count, size_t m, size_t k, size_t n, GA&& ga, GB&& gb, GC&& gc) {
+        size_t grain = std::max<size_t>(1, par_grain() / ((m * k * n) + 1));
+        auto over_batch = [&](auto kernel) {
+            par_for(count, grain, [&](size_t i0, size_t i1) {
+                for (size_t i = i0; i < i1; i++) kernel(ga(i), gb(i), gc(i));
+            });
+        };
+        auto square = [&]<size_t S>() {
+            over_batch([](T const* a, T const* b, T* c) { fixed<T, S, S, S>(a, b, c); });
+        };
+        if (m == k && k == n) {
+            switch (n) {
+            case 2:  return square.template operator()<2 >();
+            case 3:  return square.template operator()<3 >();
+            case 4:  return square.template operator()<4 >();
+            case 8:  return square.template operator()<8 >();
+            case 16: return square.template operator()<16>();
+            case 32: return square.template operator()<32>();
+            default: break;
+            }
+        }
+        over_batch([&](T const* a, T const* b, T* c) { generic(m, k, n, a, b, c); });
+    }
+
+    template<typename T, mat_maj maj, typename GA, typename GB, typename GC>
+    static void dispatch(size_t count, size_t m, size_t k, size_t n, GA&& ga, GB&& gb, GC&& gc) {
+        if constexpr (maj == mat_maj::row) run<T>(count, m, k, n, ga, gb, gc);
+        else                               run<T>(count, n, k, m, gb, ga, gc);
+    }
+};
+
+// A and B may be views of T or T const; the same goes for mat_batch below.
+template<typename T, mat_maj maj, typename A, typename B>
+    requires std::is_same_v<std::remove_const_t<A>, T> && std::is_same_v<std::remove_const_t<B>, T>
+void gemm_batch(std::span<mat<A, maj> const> a, std::span<mat<B, maj> const> b,
+                std::span<mat<T, maj> const> c) {
+    if (a.size() != b.size()) throw batch_len_mismatch(a.size(), b.size());
+    if (a.size() != c.size()) throw batch_len_mismatch(a.size(), c.size());
+    if (a.empty()) return;
+    size_t m = a[0].n_rows(), k = a[0].n_cols(), n = b[0].n_cols();
+    auto check = [](auto x, size_t rows, size_t cols) {
+        if (x.n_rows() != rows || x.n_cols() != cols)
+            throw mat_size_mismatch(rows, cols, x.n_rows(), x.n_cols());
+    };
+    for (size_t i = 0; i < a.size(); i++) {
+        check(a[i], m, k);
+        check(b[i], k, n);
+        check(c[i], m, n);
+    }
+    MATRIX_PROF_SCOPE("gemm_batch", m, n, a.size() * ((m * k) + (k * n) + (m * n)) * sizeof(T),
+                      2 * a.size() * m * k * n);
+    gemm_batch_kernel::dispatch<T, maj>(a.size(), m, k, n,
+                                        [&](size_t i) { return a[i].base_ptr(); },
+                                        [&](size_t i) { return b[i].base_ptr(); },
+                                        [&](size_t i) { return c[i].base_ptr(); });
+}
+
+// Containers of views converted to spans, e.g. gemm_batch<double, mat_maj::row>(av, bv, cv)
+// on std::vectors, where the element types cannot be deduced.
+template<typename T, mat_maj maj>
+void gemm_batch(std::span<mat<T const, maj> const> a, std::span<mat<T const, maj> const> b,
+                std::span<mat<T, maj> const> c) {
+    gemm_batch<T, maj, T const, T const>(a, b, c);
+}
+template<typename T, mat_maj maj>
+void gemm_batch(std::span<mat<T, maj> const> a, std::span<mat<T, maj> const> b,
+                std::span<mat<T, maj> const> c) {
+    gemm_batch<T, maj, T, T>(a, b, c);
+}
+
+template<typename T, mat_maj maj, typename A, typename B>
+    requires std::is_same_v<std::remove_const_t<A>, T> && std::is_same_v<std::remove_const_t<B>, T>
+void gemm_batch(mat_batch<A, maj> a, mat_batch<B, maj> b, mat_batch<T, maj> c) {
+    if (a.count != b.count) throw batch_len_mismatch(a.count, b.count);
+    if (a.count != c.count) throw batch_len_mismatch(a.count, c.count);
+    if (a.cols != b.rows) throw mat_size_mismatch(a.rows, a.cols, b.rows, b.cols);
+    if (c.rows != a.rows || c.cols != b.cols)
+        throw mat_size_mismatch(a.rows, b.cols, c.rows, c.cols);
+    MATRIX_PROF_SCOPE("gemm_batch", a.rows, b.cols,
+                      a.count * ((a.rows * a.cols) + (b.rows * b.cols) + (c.rows * c.cols))
+                              * sizeof(T),
+                      2 * a.count * a.rows * a.cols * b.cols);
+    gemm_batch_kernel::dispatch<T, maj>(a.count, a.rows, a.cols, b.cols,
+                                        [&](size_t i) { return a[i].base_ptr(); },
+                                        [&](size_t i) { return b[i].base_ptr(); },
+                                        [&](size_t i) { return c[i].base_ptr(); });
+}
+// Braced batches, e.g. gemm_batch<double, mat_maj::row>({a, count, 4, 4, 16}, ...).
+template<typename T, mat_maj maj>
+void gemm_batch(mat_batch<T const, maj> a, mat_batch<T const, maj> b, mat_batch<T, maj> c) {
+    gemm_batch<T, maj, T const, T const>(a, b, c);
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include "prof.hxx"
+#include "simd.hxx"
+#include "vec.hxx"
+#include <cmath>
+#include <limits>
+
+// Level-1 BLAS over vec views. Every kernel has a contiguous path, taken whenever all
+// operands have unit stride, that the compiler vectorizes, and a strided path that walks
+// the operands with pointer increments and scalar loads. Reductions take a sum_mode
+// (simd.hxx) to trade speed for accuracy on long vectors.
+
+/// --- updates with length unsafety ---
+// y := a x + y
+template<typename S, typename XT, bool xhs, typename YT, bool yhs> requires (!std::is_const_v<YT>)
+void axpy_nocklen(S a, vec<XT, xhs> x, vec<YT, yhs> y) noexcept {
+    XT* xp = x.ptr();
+    YT* yp = y.ptr();
+    size_t n = x.len(), xs = x.stride(), ys = y.stride();
+    if (xs == 1 && ys == 1) for (size_t i = 0; i < n; i++) yp[i] += a * xp[i];
+    else for (; n; n--, xp += xs, yp += ys) *yp += a * *xp;
+}
+// y := a x + b y
+template<typename S, typename XT, bool xhs, typename YT, bool yhs> requires (!std::is_const_v<YT>)
+void axpby_nocklen(S a, vec<XT, xhs> x, S b, vec<YT, yhs> y) noexcept {
+    XT* xp = x.ptr();
+    YT* yp = y.ptr();
+    size_t n = x.len(), xs = x.stride(), ys = y.stride();
+    if (xs == 1 && ys == 1) for (size_t i = 0; i < n; i++) yp[i] = (a * xp[i]) + (b * yp[i]);
+    else for (; n; n--, xp += xs, yp += ys) *yp = (a * *xp) + (b * *yp);
+}
+/// --- end updates with length unsafety ---
+
+/// --- updates ---
+template<typename S, typename XT, bool xhs, typename YT, bool yhs> requires (!std::is_const_v<YT>)
+void axpy(S a, vec<XT, xhs> x, vec<YT, yhs> y) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    MATRIX_PROF_SCOPE("axpy", x.len(), 1, x.len() * (sizeof(XT) + (2 * sizeof(YT))), 2 * x.len());
+    axpy_nocklen(a, x, y);
+}
+template<typename S, typename XT, bool xhs, typename YT, bool yhs> requires (!std::is_const_v<YT>)
+void axpby(S a, vec<XT, xhs> x, S b, vec<YT, yhs> y) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    MATRIX_PROF_SCOPE("axpby", x.len(), 1, x.len() * (sizeof(XT) + (2 * sizeof(YT))), 3 * x.len());
+    axpby_nocklen(a, x, b, y);
+}
+// x := a x
+template<typename S, typename T, bool hs> requires (!std::is_const_v<T>)
+void scal(S a, vec<T, hs> x) noexcept {
+    MATRIX_PROF_SCOPE("scal", x.len(), 1, 2 * x.len() * sizeof(T), x.len());
+    T* xp = x.ptr();
+    size_t n = x.len(), xs = x.stride();
+    if (xs == 1) for (size_t i = 0; i < n; i++) xp[i] *= a;
+    else for (; n; n--, xp += xs) *xp *= a;
+}
+/// --- end updates ---
+
+/// --- reductions ---
+// Sum of elements.
+template<typename T, bool hs>
+[[nodiscard]] std::remove_const_t<T> sum(vec<T, hs> x, sum_mode m = sum_mode::fast) noexcept {
+    MATRIX_PROF_SCOPE("sum", x.len(), 1, x.len() * sizeof(T), x.len());
+    using U = std::remove_const_t<T>;
+    T* xp = x.ptr();
+    size_t xs = x.stride();
+    if (xs == 1) return lane_sum<U>(m, x.len(), [&](size_t i) { return xp[i]; });
+    return lane_sum<U, 4>(m, x.len(), [&](size_t i) { return xp[i * xs]; });
+}
+
+// Sum of absolute values.
+template<typename T, bool hs>
+[[nodiscard]] std::remove_const_t<T> asum(vec<T, hs> x, sum_mode m = sum_mode::fast) noexcept {
+    MATRIX_PROF_SCOPE("asum", x.len(), 1, x.len() * sizeof(T), 2 * x.len());
+    using U = std::remove_const_t<T>;
+    T* xp = x.ptr();
+    size_t xs = x.stride();
+    if (xs == 1) return lane_sum<U>(m, x.len(), [&](size_t i) { return U(std::abs(xp[i])); });
+    return lane_sum<U, 4>(m, x.len(), [&](size_t i) { return U(std::abs(xp[i * xs])); });
+}
+
+// Inner product; x * y is dot(x, y, sum_mode::fast).
+template<typename XT, bool xhs, typename YT, bool yhs>
+[[nodiscard]] std::remove_const_t<XT> dot_nocklen(vec<XT, xhs> x, vec<YT, yhs> y,
+                                                  sum_mode m = sum_mode::fast) noexcept {
+    using U = std::remove_const_t<XT>;
+    XT* xp = x.ptr();
+    YT* yp = y.ptr();
+    size_t xs = x.stride(), ys = y.stride();
+    if (xs == 1 && ys == 1) return lane_sum<U>(m, x.len(), [&](size_t i) { return xp[i] * yp[i]; });
+    return lane_sum<U, 4>(m, x.len(), [&](size_t i) { return xp[i * xs] * yp[i * ys]; });
+}
+template<typename XT, bool xhs, typename YT, bool yhs>
+[[nodiscard]] std::remove_const_t<XT> dot(vec<XT, xhs> x, vec<YT, yhs> y,
+                                          sum_mode m = sum_mode::fast) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    MATRIX_PROF_SCOPE("dot", x.len(), 1, x.len() * (sizeof(XT) + sizeof(YT)), 2 * x.len());
+    return dot_nocklen(x, y, m);
+}
+
+// y := a x + y, returning the updated y . z from the same pass; z may be y.
+// lane_sum makes every term exactly once, so y is updated as the terms are made.
+template<typename S, typename XT, bool xhs, typename YT, bool yhs, typename ZT, bool zhs>
+    requires (!std::is_const_v<YT>)
+[[nodiscard]] YT axpy_dot_nocklen(S a, vec<XT, xhs> x, vec<YT, yhs> y, vec<ZT, zhs> z,
+                                  sum_mode m = sum_mode::fast) noexcept {
+    XT* xp = x.ptr();
+    YT* yp = y.ptr();
+    ZT* zp = z.ptr();
+    size_t xs = x.stride(), ys = y.stride(), zs = z.stride();
+    if (xs == 1 && ys == 1 && zs == 1) {
+        return lane_sum<YT>(m, x.len(), [&](size_t i) {
+            YT yi = yp[i] + (a * xp[i]);
+            yp[i] = yi;
+            return yi * zp[i];
+        });
+    }
+    return lane_sum<YT, 4>(m, x.len(), [&](size_t i) {
+        YT yi = yp[i * ys] + (a * xp[i * xs]);
+        yp[i * ys] = yi;
+        return yi * zp[i * zs];
+    });
+}
+template<typename S, typename XT, bool xhs, typename YT, bool yhs, typename ZT, bool zhs>
+    requires (!std::is_const_v<YT>)
+[[nodiscard]] YT axpy_dot(S a, vec<XT, xhs> x, vec<YT, yhs> y, vec<ZT, zhs> z,
+                          sum_mode m = sum_mode::fast) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    if (x.len() != z.len()) throw vec_len_mismatch(x.len(), z.len());
+    MATRIX_PROF_SCOPE("axpy_dot", x.len(), 1,
+                      x.len() * (sizeof(XT) + (2 * sizeof(YT)) + sizeof(ZT)), 4 * x.len());
+    return axpy_dot_nocklen(a, x, y, z, m);
+}
+
+// Index of the first element of largest absolute value, 0 for an empty vector.
+template<typename T, bool hs>
+[[nodiscard]] size_t iamax(vec<T, hs> x) noexcept {
+    MATRIX_PROF_SCOPE("iamax", x.len(), 1, x.len() * sizeof(T), 2 * x.len());
+    T* xp = x.ptr();
+    size_t xs = x.stride(), best = 0;
+    std::remove_const_t<T> best_abs {};
+    for (size_t i = 0; i < x.len(); i++, xp += xs) {
+        auto a = std::abs(*xp);
+        if (a > best_abs || (i == 0)) { best_abs = a; best = i; }
+    }
+    return best;
+}
+
+// Euclidean norm that neither overflows nor underflows in intermediate squares:
+// the plain sum of squares is used when it lands in the safe range, otherwise
+// the vector is summed again scaled by its largest magnitude.
+template<typename T, bool hs> requires std::is_floating_point_v<std::remove_const_t<T>>
+[[nodiscard]] std::remove_const_t<T> nrm2(vec<T, hs> x, sum_mode m = sum_mode::fast) noexcept {
+    using U = std::remove_const_t<T>;
+    using lim = std::numeric_limits<U>;
+    MATRIX_PROF_SCOPE("nrm2", x.len(), 1, x.len() * sizeof(T), 2 * x.len());
+    T* xp = x.ptr();
+    size_t n = x.len(), xs = x.stride();
+    auto sq = [&](size_t i) { return xp[i * xs] * xp[i * xs]; };
+    U ssq = xs == 1 ? lane_sum<U>(m, n, [&](size_t i) { return xp[i] * xp[i]; })
+                    : lane_sum<U, 4>(m, n, sq);
+    if (std::isnan(ssq)) return ssq;
+    if (ssq < lim::infinity() && ssq >= lim::min() / lim::epsilon()) return std::sqrt(ssq);
+
+    U amax {};
+    for (size_t i = 0; i < n; i++) amax = std::max(amax, std::abs(xp[i * xs]));
+    if (amax == 0 || amax == lim::infinity()) return amax;
+    U ssq_scaled = lane_sum<U, 4>(m, n, [&](size_t i) { U s = xp[i * xs] / amax; return s * s; });
+    return amax * std::sqrt(ssq_scaled);
+}
+/// --- end reductions ---
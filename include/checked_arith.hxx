@@ -1,6 +1,11 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 template<typename T>
 bool ret_checked_add(T& dst, T a, T b) { return !__builtin_add_overflow(a, b, &dst); }
@@ -23,7 +28,7 @@ template<> inline size_t checked_add<size_t>(size_t a, size_t b) {
 template<typename T>
 [[nodiscard]] T checked_sub(T a, T b) {
     T ret;
-    if (!checked_sub(ret, a, b)) throw std::overflow_error("overflow in checked subtracition");
+    if (!ret_checked_sub(ret, a, b)) throw std::overflow_error("overflow in checked subtraction");
     return ret;
 }
 template<> inline size_t checked_sub<size_t>(size_t a, size_t b) {
@@ -42,3 +47,180 @@ template<> inline size_t checked_mul<size_t>(size_t a, size_t b) {
     if (!ret_checked_mul(ret, a, b)) throw std::bad_array_new_length();
     return ret;
 }
+
+/// --- checked arithmetic over arrays ---
+// dst[i] := a[i] op b[i] (or a[i] op b for a scalar b) over n elements, throwing what the
+// scalar functions above throw if any element overflows. Elements are computed branch-free
+// with their overflow flags, which are ORed and tested once per block, so the loops
+// vectorize. dst may alias a, b or c; when the functions throw, dst is unspecified.
+enum class int_op { add, sub, mul };
+
+// Wrapped results with their overflow flags, and the values saturation clamps them to.
+template<typename T> requires std::is_integral_v<T>
+struct int_ops final {
+    using U = std::make_unsigned_t<T>;
+    using lim = std::numeric_limits<T>;
+    static constexpr bool is_signed = lim::is_signed;
+
+    template<int_op op>
+    [[nodiscard]] static T apply(T a, T b, bool& o) noexcept {
+        if constexpr (op == int_op::add) {
+            T r = T(U(a) + U(b));
+            o = is_signed ? T((a ^ r) & (b ^ r)) < 0 : r < a;
+            return r;
+        } else if constexpr (op == int_op::sub) {
+            T r = T(U(a) - U(b));
+            o = is_signed ? T((a ^ b) & (a ^ r)) < 0 : a < b;
+            return r;
+        } else if constexpr (sizeof(T) < sizeof(int64_t)) {
+            using W = std::conditional_t<is_signed, int64_t, uint64_t>;
+            W p = W(a) * W(b);
+            o = p < W(lim::min()) || p > W(lim::max());
+            return T(p);
+        } else {
+            T r;
+            o = __builtin_mul_overflow(a, b, &r);
+            return r;
+        }
+    }
+    // Value of a saturated result, given that a op b overflowed.
+    template<int_op op>
+    [[nodiscard]] static T saturated(T a, T b) noexcept {
+        if constexpr (!is_signed) return op == int_op::sub ? lim::min() : lim::max();
+        else if constexpr (op == int_op::mul) return T(lim::max() ^ T((a ^ b) >> lim::digits));
+        else                                  return T(lim::max() ^ T(a >> lim::digits));
+    }
+};
+
+// Blocks of elements whose overflow flags are combined before they are tested, shared by
+// the array functions here and int_arith (int_arith.hxx).
+struct int_flags final {
+    static constexpr size_t block = 256;
+
+    // ORs the flags f(i) returns for i in [0, n), f computing element i on the way. Flags are
+    // integers U as wide as the elements, which vectorizes where ORing bools does not.
+    template<typename U, typename F>
+    [[nodiscard]] static U any(size_t n, F&& f) noexcept(noexcept(f(size_t {}))) {
+        U o = 0;
+        for (size_t i = 0; i < n; i++) o |= f(i);
+        return o;
+    }
+};
+
+template<typename T> requires std::is_integral_v<T>
+struct checked_kernel final {
+    static constexpr size_t block = int_flags::block;
+
+    template<int_op op>
+    [[noreturn]] static void fail() {
+        if constexpr (std::is_same_v<T, size_t>) throw std::bad_array_new_length();
+        else if constexpr (op == int_op::add)
+            throw std::overflow_error("overflow in checked addition");
+        else if constexpr (op == int_op::sub)
+            throw std::overflow_error("overflow in checked subtraction");
+        else
+            throw std::overflow_error("overflow in checked multiplication");
+    }
+
+    // dst[i] := a[i] op gb(i), plus c[i] unless c is null.
+    // Products are screened per block rather than flagged per element: no product of
+    // operands below 2^(digits / 2) in magnitude overflows, so blocks without larger operands
+    // multiply without checks, and the rest are computed one element at a time.
+    template<int_op op, typename GB>
+    static void run(size_t n, T const* a, GB const& gb, T const* c, T* dst) {
+        for (size_t b0 = 0; b0 < n; b0 += block) {
+            size_t bn = std::min(block, n - b0);
+            T const* ab = a + b0;
+            T const* cb = c ? c + b0 : nullptr;
+            T*       db = dst + b0;
+            auto     bb = [&](size_t i) { return gb(b0 + i); };
+            if constexpr (op == int_op::mul) {
+                U big = 0;
+                for (size_t i = 0; i < bn; i++) big |= mag(ab[i]) | mag(bb(i));
+                if (big >> (std::numeric_limits<T>::digits / 2)) {
+                    exact<op>(bn, ab, bb, cb, db);
+                    continue;
+                }
+            }
+            auto [o_op, o_add] = c ? fused<op, true >(bn, ab, bb, cb, db)
+                                   : fused<op, false>(bn, ab, bb, cb, db);
+            if (o_op)  fail<op>();
+            if (o_add) fail<int_op::add>();
+        }
+    }
+
+private:
+    using U = std::make_unsigned_t<T>;
+
+    // One pass over a block, returning whether any a[i] op b[i], or any addition of c[i],
+    // overflowed. Products are screened already and wrap unchecked. Every element is written
+    // after its operands are read, so dst may alias them.
+    template<int_op op, bool has_c, typename GB>
+    [[nodiscard]] static std::pair<bool, bool> fused(size_t n, T const* a, GB const& gb,
+                                                     T const* c, T* dst) noexcept {
+        using ops = int_ops<T>;
+        U o = int_flags::any<U>(n, [&](size_t i) {
+            bool o_op = false, o_add = false;
+            T r = op == int_op::mul ? T(U(a[i]) * U(gb(i)))
+                                    : ops::template apply<op>(a[i], gb(i), o_op);
+            if constexpr (has_c) r = ops::template apply<int_op::add>(r, c[i], o_add);
+            dst[i] = r;
+            return U(U(o_op) | U(U(o_add) << 1));
+        });
+        return {(o & 1) != 0, (o & 2) != 0};
+    }
+
+    // The block element by element, throwing at the first overflow.
+    template<int_op op, typename GB>
+    static void exact(size_t n, T const* a, GB const& gb, T const* c, T* dst) {
+        for (size_t i = 0; i < n; i++) {
+            T r;
+            bool o = op == int_op::add ? __builtin_add_overflow(a[i], gb(i), &r)
+                   : op == int_op::sub ? __builtin_sub_overflow(a[i], gb(i), &r)
+                   :                     __builtin_mul_overflow(a[i], gb(i), &r);
+            if (o) fail<op>();
+            if (c && __builtin_add_overflow(r, c[i], &r)) fail<int_op::add>();
+            dst[i] = r;
+        }
+    }
+
+    // x, or ~x for negative x: at least |x| - 1, with the same highest set bit.
+    [[nodiscard]] static U mag(T x) noexcept {
+        if constexpr (std::is_signed_v<T>) return U(x ^ (x >> std::numeric_limits<T>::digits));
+        else                               return U(x);
+    }
+};
+
+template<typename T>
+void checked_add(size_t n, T const* a, T const* b, T* dst) {
+    checked_kernel<T>::template run<int_op::add>(n, a, [&](size_t i) { return b[i]; }, nullptr,
+                                                 dst);
+}
+template<typename T>
+void checked_add(size_t n, T const* a, std::type_identity_t<T> b, T* dst)
+    { checked_kernel<T>::template run<int_op::add>(n, a, [=](size_t) { return b; }, nullptr, dst); }
+template<typename T>
+void checked_sub(size_t n, T const* a, T const* b, T* dst) {
+    checked_kernel<T>::template run<int_op::sub>(n, a, [&](size_t i) { return b[i]; }, nullptr,
+                                                 dst);
+}
+template<typename T>
+void checked_sub(size_t n, T const* a, std::type_identity_t<T> b, T* dst)
+    { checked_kernel<T>::template run<int_op::sub>(n, a, [=](size_t) { return b; }, nullptr, dst); }
+template<typename T>
+void checked_mul(size_t n, T const* a, T const* b, T* dst) {
+    checked_kernel<T>::template run<int_op::mul>(n, a, [&](size_t i) { return b[i]; }, nullptr,
+                                                 dst);
+}
+template<typename T>
+void checked_mul(size_t n, T const* a, std::type_identity_t<T> b, T* dst)
+    { checked_kernel<T>::template run<int_op::mul>(n, a, [=](size_t) { return b; }, nullptr, dst); }
+
+// dst[i] := a[i] * b[i] + c[i], or a[i] * b + c[i]: offsets such as row * ld + col.
+template<typename T>
+void checked_mul_add(size_t n, T const* a, T const* b, T const* c, T* dst)
+    { checked_kernel<T>::template run<int_op::mul>(n, a, [&](size_t i) { return b[i]; }, c, dst); }
+template<typename T>
+void checked_mul_add(size_t n, T const* a, std::type_identity_t<T> b, T const* c, T* dst)
+    { checked_kernel<T>::template run<int_op::mul>(n, a, [=](size_t) { return b; }, c, dst); }
+/// --- end checked arithmetic over arrays ---
@@ -0,0 +1,213 @@
+#pragma once
+#include "mat.hxx"
+#include "par.hxx"
+#include "prof.hxx"
+#include "tune.hxx"
+
+// Element-wise map, zip and reductions of vec and mat views with user functions, in place
+// of index loops through the checked operator []. Loops walk raw storage: vectors of unit
+// stride, and matrices stored in the same order as the output (for reductions, as the first
+// operand), are traversed contiguously so that the function vectorizes; other operands are
+// walked with strides. Work is split across par_threads() threads in parts of at least
+// tuned().dense_grain elements. Reductions combine their parts in index order (par_reduce),
+// so for a given thread count the result does not depend on scheduling, and with
+// par_reproducible() set not on the thread count either; their op must be associative and
+// commutative, as for std::reduce.
+
+struct ewise_kernel final {
+    template<typename XT, typename YT, typename F>
+    static void map(size_t n, XT* x, size_t xs, YT* y, size_t ys, F& f) {
+        if (xs == 1 && ys == 1) for (size_t i = 0; i < n; i++) y[i] = f(x[i]);
+        else for (; n; n--, x += xs, y += ys) *y = f(*x);
+    }
+    template<typename XT, typename YT, typename ZT, typename F>
+    static void zip(size_t n, XT* x, size_t xs, YT* y, size_t ys, ZT* z, size_t zs, F& f) {
+        if (xs == 1 && ys == 1 && zs == 1) for (size_t i = 0; i < n; i++) z[i] = f(x[i], y[i]);
+        else for (; n; n--, x += xs, y += ys, z += zs) *z = f(*x, *y);
+    }
+
+    // fn(i0, i1) over parts of [0, n) elements.
+    template<typename F>
+    static void flat(size_t n, F&& fn) { par_for(n, tuned().dense_grain, fn); }
+    // fn(i) for every one of n_out majvecs of n_in elements.
+    template<typename F>
+    static void outer(size_t n_out, size_t n_in, F&& fn) {
+        par_for(n_out, std::max<size_t>(1, tuned().dense_grain / (n_in + 1)),
+                [&](size_t i0, size_t i1) { for (size_t i = i0; i < i1; i++) fn(i); });
+    }
+
+    // Distance between consecutive majvecs (.first) and elements (.second) of m when it is
+    // walked in the storage order lead.
+    template<mat_maj lead, typename T, mat_maj maj>
+    [[nodiscard]] static std::pair<size_t, size_t> walk(mat<T, maj> m) noexcept {
+        if constexpr (lead == mat_maj::row) return {m.row_stride(), m.col_stride()};
+        else                                return {m.col_stride(), m.row_stride()};
+    }
+};
+
+/// --- vectors with length unsafety ---
+// y[i] := f(x[i])
+template<typename XT, bool xhs, typename YT, bool yhs, typename F> requires (!std::is_const_v<YT>)
+void map_nocklen(vec<XT, xhs> x, vec<YT, yhs> y, F&& f) {
+    size_t xs = x.stride(), ys = y.stride();
+    ewise_kernel::flat(x.len(), [&](size_t i0, size_t i1) {
+        ewise_kernel::map(i1 - i0, x.ptr() + (i0 * xs), xs, y.ptr() + (i0 * ys), ys, f);
+    });
+}
+// z[i] := f(x[i], y[i])
+template<typename XT, bool xhs, typename YT, bool yhs, typename ZT, bool zhs, typename F>
+    requires (!std::is_const_v<ZT>)
+void zip_with_nocklen(vec<XT, xhs> x, vec<YT, yhs> y, vec<ZT, zhs> z, F&& f) {
+    size_t xs = x.stride(), ys = y.stride(), zs = z.stride();
+    ewise_kernel::flat(x.len(), [&](size_t i0, size_t i1) {
+        ewise_kernel::zip(i1 - i0, x.ptr() + (i0 * xs), xs, y.ptr() + (i0 * ys), ys,
+                          z.ptr() + (i0 * zs), zs, f);
+    });
+}
+// init op f(x[0], y[0]) op f(x[1], y[1]) ...
+template<typename XT, bool xhs, typename YT, bool yhs, typename R, typename Op, typename F>
+[[nodiscard]] R transform_reduce_nocklen(vec<XT, xhs> x, vec<YT, yhs> y, R init, Op&& op,
+                                         F&& f) {
+    XT* xp = x.ptr();
+    YT* yp = y.ptr();
+    size_t xs = x.stride(), ys = y.stride(), grain = tuned().dense_grain;
+    if (xs == 1 && ys == 1)
+        return par_reduce(x.len(), grain, init, op, [&](size_t i) { return f(xp[i], yp[i]); });
+    return par_reduce<R, 4>(x.len(), grain, init, op,
+                            [&](size_t i) { return f(xp[i * xs], yp[i * ys]); });
+}
+/// --- end vectors with length unsafety ---
+
+/// --- vectors ---
+template<typename XT, bool xhs, typename YT, bool yhs, typename F> requires (!std::is_const_v<YT>)
+void map(vec<XT, xhs> x, vec<YT, yhs> y, F&& f) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    MATRIX_PROF_SCOPE("map", x.len(), 1, x.len() * (sizeof(XT) + sizeof(YT)), x.len());
+    map_nocklen(x, y, f);
+}
+template<typename XT, bool xhs, typename YT, bool yhs, typename ZT, bool zhs, typename F>
+    requires (!std::is_const_v<ZT>)
+void zip_with(vec<XT, xhs> x, vec<YT, yhs> y, vec<ZT, zhs> z, F&& f) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    if (x.len() != z.len()) throw vec_len_mismatch(x.len(), z.len());
+    MATRIX_PROF_SCOPE("zip_with", x.len(), 1, x.len() * (sizeof(XT) + sizeof(YT) + sizeof(ZT)),
+                      x.len());
+    zip_with_nocklen(x, y, z, f);
+}
+template<typename XT, bool xhs, typename YT, bool yhs, typename R, typename Op, typename F>
+[[nodiscard]] R transform_reduce(vec<XT, xhs> x, vec<YT, yhs> y, R init, Op&& op, F&& f) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    MATRIX_PROF_SCOPE("transform_reduce", x.len(), 1, x.len() * (sizeof(XT) + sizeof(YT)),
+                      2 * x.len());
+    return transform_reduce_nocklen(x, y, init, op, f);
+}
+// init op f(x[0]) op f(x[1]) ...
+template<typename T, bool hs, typename R, typename Op, typename F>
+[[nodiscard]] R transform_reduce(vec<T, hs> x, R init, Op&& op, F&& f) {
+    MATRIX_PROF_SCOPE("transform_reduce", x.len(), 1, x.len() * sizeof(T), 2 * x.len());
+    T* xp = x.ptr();
+    size_t xs = x.stride(), grain = tuned().dense_grain;
+    if (xs == 1) return par_reduce(x.len(), grain, init, op, [&](size_t i) { return f(xp[i]); });
+    return par_reduce<R, 4>(x.len(), grain, init, op, [&](size_t i) { return f(xp[i * xs]); });
+}
+// init op x[0] op x[1] ...
+template<typename T, bool hs, typename R, typename Op>
+[[nodiscard]] R reduce(vec<T, hs> x, R init, Op&& op)
+    { return transform_reduce(x, init, op, [](auto v) { return R(v); }); }
+/// --- end vectors ---
+
+/// --- matrices with size unsafety ---
+// c(i, j) := f(a(i, j)), walking c in its storage order.
+template<typename AT, mat_maj am, typename CT, mat_maj cm, typename F>
+    requires (!std::is_const_v<CT>)
+void map_nocklen(mat<AT, am> a, mat<CT, cm> c, F&& f) {
+    if constexpr (am == cm) {
+        size_t n = c.n_rows() * c.n_cols();
+        map_nocklen(vec<AT, false>(a.base_ptr(), n), vec<CT, false>(c.base_ptr(), n), f);
+    } else {
+        auto [ao, ai] = ewise_kernel::walk<cm>(a);
+        size_t n = c.n_min();
+        ewise_kernel::outer(c.n_maj(), n, [&](size_t i) {
+            ewise_kernel::map(n, a.base_ptr() + (i * ao), ai, c.base_ptr() + (i * n), 1, f);
+        });
+    }
+}
+// c(i, j) := f(a(i, j), b(i, j)), walking c in its storage order.
+template<typename AT, mat_maj am, typename BT, mat_maj bm, typename CT, mat_maj cm, typename F>
+    requires (!std::is_const_v<CT>)
+void zip_with_nocklen(mat<AT, am> a, mat<BT, bm> b, mat<CT, cm> c, F&& f) {
+    if constexpr (am == cm && bm == cm) {
+        size_t n = c.n_rows() * c.n_cols();
+        zip_with_nocklen(vec<AT, false>(a.base_ptr(), n), vec<BT, false>(b.base_ptr(), n),
+                         vec<CT, false>(c.base_ptr(), n), f);
+    } else {
+        auto [ao, ai] = ewise_kernel::walk<cm>(a);
+        auto [bo, bi] = ewise_kernel::walk<cm>(b);
+        size_t n = c.n_min();
+        ewise_kernel::outer(c.n_maj(), n, [&](size_t i) {
+            ewise_kernel::zip(n, a.base_ptr() + (i * ao), ai, b.base_ptr() + (i * bo), bi,
+                              c.base_ptr() + (i * n), 1, f);
+        });
+    }
+}
+// Folds f(a(i, j), b(i, j)), walking a in its storage order.
+template<typename AT, mat_maj am, typename BT, mat_maj bm, typename R, typename Op, typename F>
+[[nodiscard]] R transform_reduce_nocklen(mat<AT, am> a, mat<BT, bm> b, R init, Op&& op,
+                                         F&& f) {
+    if constexpr (am == bm) {
+        size_t n = a.n_rows() * a.n_cols();
+        return transform_reduce_nocklen(vec<AT, false>(a.base_ptr(), n),
+                                        vec<BT, false>(b.base_ptr(), n), init, op, f);
+    } else {
+        size_t n = a.n_min();
+        if (n == 0) return init;
+        auto [bo, bi] = ewise_kernel::walk<am>(b);
+        return par_reduce(a.n_maj(), std::max<size_t>(1, tuned().dense_grain / n), init, op,
+                          [&](size_t i) {
+            AT const* ap = a.base_ptr() + (i * n);
+            BT const* bp = b.base_ptr() + (i * bo);
+            return lane_fold<R, 4>(n, op, [&](size_t k) { return f(ap[k], bp[k * bi]); });
+        });
+    }
+}
+/// --- end matrices with size unsafety ---
+
+/// --- matrices ---
+template<typename AT, mat_maj am, typename CT, mat_maj cm, typename F>
+    requires (!std::is_const_v<CT>)
+void map(mat<AT, am> a, mat<CT, cm> c, F&& f) {
+    if (a.n_rows() != c.n_rows() || a.n_cols() != c.n_cols())
+        throw mat_size_mismatch(a.n_rows(), a.n_cols(), c.n_rows(), c.n_cols());
+    size_t n = a.n_rows() * a.n_cols();
+    MATRIX_PROF_SCOPE("map", a.n_rows(), a.n_cols(), n * (sizeof(AT) + sizeof(CT)), n);
+    map_nocklen(a, c, f);
+}
+template<typename AT, mat_maj am, typename BT, mat_maj bm, typename CT, mat_maj cm, typename F>
+    requires (!std::is_const_v<CT>)
+void zip_with(mat<AT, am> a, mat<BT, bm> b, mat<CT, cm> c, F&& f) {
+    if (a.n_rows() != b.n_rows() || a.n_cols() != b.n_cols())
+        throw mat_size_mismatch(a.n_rows(), a.n_cols(), b.n_rows(), b.n_cols());
+    if (a.n_rows() != c.n_rows() || a.n_cols() != c.n_cols())
+        throw mat_size_mismatch(a.n_rows(), a.n_cols(), c.n_rows(), c.n_cols());
+    size_t n = a.n_rows() * a.n_cols();
+    MATRIX_PROF_SCOPE("zip_with", a.n_rows(), a.n_cols(),
+                      n * (sizeof(AT) + sizeof(BT) + sizeof(CT)), n);
+    zip_with_nocklen(a, b, c, f);
+}
+template<typename AT, mat_maj am, typename BT, mat_maj bm, typename R, typename Op, typename F>
+[[nodiscard]] R transform_reduce(mat<AT, am> a, mat<BT, bm> b, R init, Op&& op, F&& f) {
+    if (a.n_rows() != b.n_rows() || a.n_cols() != b.n_cols())
+        throw mat_size_mismatch(a.n_rows(), a.n_cols(), b.n_rows(), b.n_cols());
+    size_t n = a.n_rows() * a.n_cols();
+    MATRIX_PROF_SCOPE("transform_reduce", a.n_rows(), a.n_cols(), n * (sizeof(AT) + sizeof(BT)),
+                      2 * n);
+    return transform_reduce_nocklen(a, b, init, op, f);
+}
+// Matrices are one contiguous array, so unary reductions are reductions of it.
+template<typename T, mat_maj maj, typename R, typename Op, typename F>
+[[nodiscard]] R transform_reduce(mat<T, maj> a, R init, Op&& op, F&& f)
+    { return transform_reduce(vec<T, false>(a.base_ptr(), a.n_rows() * a.n_cols()), init, op, f); }
+template<typename T, mat_maj maj, typename R, typename Op>
+[[nodiscard]] R reduce(mat<T, maj> a, R init, Op&& op)
+    { return reduce(vec<T, false>(a.base_ptr(), a.n_rows() * a.n_cols()), init, op); }
+/// --- end matrices ---
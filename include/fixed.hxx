@@ -0,0 +1,187 @@
+#pragma once
+#include "mat.hxx"
+
+// Vectors and matrices with compile-time dimensions and inline storage. Arithmetic is
+// constexpr, operands of different shapes simply have no matching operator, and views
+// convert them to vec and mat for use with the rest of the library.
+
+template<typename T, size_t N>
+struct fixed_vec final {
+    static_assert(!std::is_const_v<T>);
+
+    /// --- fields ---
+    T elems[N] {};
+    /// --- end fields ---
+
+    /// --- accessors ---
+    [[nodiscard]] static constexpr size_t len() noexcept { return N; }
+
+    [[nodiscard]] constexpr T& operator [](size_t i) {
+        if (i >= N) throw vec_out_of_bounds(i);
+        return elems[i];
+    }
+    [[nodiscard]] constexpr T const& operator [](size_t i) const {
+        if (i >= N) throw vec_out_of_bounds(i);
+        return elems[i];
+    }
+    template<size_t I> [[nodiscard]] constexpr T&       get()       noexcept
+        { static_assert(I < N); return elems[I]; }
+    template<size_t I> [[nodiscard]] constexpr T const& get() const noexcept
+        { static_assert(I < N); return elems[I]; }
+    /// --- end accessors ---
+
+    /// --- views ---
+    [[nodiscard]] vec<T      , false> as_vec()       noexcept { return vec<T, false>(elems, N); }
+    [[nodiscard]] vec<T const, false> as_vec() const noexcept
+        { return vec<T const, false>(elems, N); }
+    [[nodiscard]] operator vec<T      , false>() &      noexcept { return as_vec(); }
+    [[nodiscard]] operator vec<T const, false>() const& noexcept { return as_vec(); }
+    /// --- end views ---
+
+    /// --- comparison ---
+    [[nodiscard]] constexpr bool operator ==(fixed_vec const& o) const noexcept {
+        for (size_t i = 0; i < N; i++) if (elems[i] != o.elems[i]) return false;
+        return true;
+    }
+    /// --- end comparison ---
+
+    /// --- arithmetic ---
+    constexpr fixed_vec& operator +=(fixed_vec const& o) noexcept
+        { for (size_t i = 0; i < N; i++) elems[i] += o.elems[i]; return *this; }
+    constexpr fixed_vec& operator -=(fixed_vec const& o) noexcept
+        { for (size_t i = 0; i < N; i++) elems[i] -= o.elems[i]; return *this; }
+    constexpr fixed_vec& operator *=(T v) noexcept
+        { for (size_t i = 0; i < N; i++) elems[i] *= v; return *this; }
+    constexpr fixed_vec& operator /=(T v) noexcept
+        { for (size_t i = 0; i < N; i++) elems[i] /= v; return *this; }
+
+    [[nodiscard]] constexpr fixed_vec operator +(fixed_vec const& o) const noexcept
+        { fixed_vec r = *this; return r += o; }
+    [[nodiscard]] constexpr fixed_vec operator -(fixed_vec const& o) const noexcept
+        { fixed_vec r = *this; return r -= o; }
+    [[nodiscard]] constexpr fixed_vec operator *(T v) const noexcept
+        { fixed_vec r = *this; return r *= v; }
+    [[nodiscard]] constexpr fixed_vec operator /(T v) const noexcept
+        { fixed_vec r = *this; return r /= v; }
+
+    // Dot product.
+    [[nodiscard]] constexpr T operator *(fixed_vec const& o) const noexcept {
+        T s {};
+        for (size_t i = 0; i < N; i++) s += elems[i] * o.elems[i];
+        return s;
+    }
+    /// --- end arithmetic ---
+};
+
+template<typename T, size_t R, size_t C, mat_maj maj = mat_maj::row>
+struct fixed_mat final {
+    static_assert(!std::is_const_v<T>);
+
+    /// --- fields ---
+    T elems[R * C] {};
+    /// --- end fields ---
+
+    [[nodiscard]] static constexpr fixed_mat identity() noexcept {
+        fixed_mat m;
+        for (size_t i = 0; i < std::min(R, C); i++) m.elems[idx(i, i)] = T {1};
+        return m;
+    }
+
+    /// --- accessors ---
+    [[nodiscard]] static constexpr size_t n_rows() noexcept { return R; }
+    [[nodiscard]] static constexpr size_t n_cols() noexcept { return C; }
+    [[nodiscard]] static constexpr size_t idx(size_t r, size_t c) noexcept
+        { return maj == mat_maj::row ? (r * C) + c : (c * R) + r; }
+
+    [[nodiscard]] constexpr T& operator ()(size_t r, size_t c) {
+        if (r >= R) throw mat_out_of_bounds(r, false);
+        if (c >= C) throw mat_out_of_bounds(c, true);
+        return elems[idx(r, c)];
+    }
+    [[nodiscard]] constexpr T const& operator ()(size_t r, size_t c) const {
+        if (r >= R) throw mat_out_of_bounds(r, false);
+        if (c >= C) throw mat_out_of_bounds(c, true);
+        return elems[idx(r, c)];
+    }
+    template<size_t I, size_t J> [[nodiscard]] constexpr T&       get()       noexcept
+        { static_assert(I < R && J < C); return elems[idx(I, J)]; }
+    template<size_t I, size_t J> [[nodiscard]] constexpr T const& get() const noexcept
+        { static_assert(I < R && J < C); return elems[idx(I, J)]; }
+    /// --- end accessors ---
+
+    /// --- views ---
+    [[nodiscard]] mat<T      , maj> as_mat()       noexcept { return mat<T, maj>(elems, R, C); }
+    [[nodiscard]] mat<T const, maj> as_mat() const noexcept
+        { return mat<T const, maj>(elems, R, C); }
+    [[nodiscard]] operator mat<T      , maj>() &      noexcept { return as_mat(); }
+    [[nodiscard]] operator mat<T const, maj>() const& noexcept { return as_mat(); }
+
+    [[nodiscard]] auto row(size_t r)       { return as_mat().row(r); }
+    [[nodiscard]] auto row(size_t r) const { return as_mat().row(r); }
+    [[nodiscard]] auto col(size_t c)       { return as_mat().col(c); }
+    [[nodiscard]] auto col(size_t c) const { return as_mat().col(c); }
+    [[nodiscard]] auto operator [](size_t r)       { return row(r); }
+    [[nodiscard]] auto operator [](size_t r) const { return row(r); }
+    /// --- end views ---
+
+    /// --- comparison ---
+    template<mat_maj om>
+    [[nodiscard]] constexpr bool operator ==(fixed_mat<T, R, C, om> const& o) const noexcept {
+        for (size_t r = 0; r < R; r++) for (size_t c = 0; c < C; c++)
+            if (elems[idx(r, c)] != o.elems[o.idx(r, c)]) return false;
+        return true;
+    }
+    /// --- end comparison ---
+
+    /// --- arithmetic ---
+    template<mat_maj om>
+    constexpr fixed_mat& operator +=(fixed_mat<T, R, C, om> const& o) noexcept {
+        for (size_t r = 0; r < R; r++) for (size_t c = 0; c < C; c++)
+            elems[idx(r, c)] += o.elems[o.idx(r, c)];
+        return *this;
+    }
+    template<mat_maj om>
+    constexpr fixed_mat& operator -=(fixed_mat<T, R, C, om> const& o) noexcept {
+        for (size_t r = 0; r < R; r++) for (size_t c = 0; c < C; c++)
+            elems[idx(r, c)] -= o.elems[o.idx(r, c)];
+        return *this;
+    }
+    constexpr fixed_mat& operator *=(T v) noexcept
+        { for (auto& e : elems) e *= v; return *this; }
+
+    template<mat_maj om>
+    [[nodiscard]] constexpr fixed_mat operator +(fixed_mat<T, R, C, om> const& o) const noexcept
+        { fixed_mat m = *this; return m += o; }
+    template<mat_maj om>
+    [[nodiscard]] constexpr fixed_mat operator -(fixed_mat<T, R, C, om> const& o) const noexcept
+        { fixed_mat m = *this; return m -= o; }
+    [[nodiscard]] constexpr fixed_mat operator *(T v) const noexcept
+        { fixed_mat m = *this; return m *= v; }
+
+    template<size_t K, mat_maj om>
+    [[nodiscard]] constexpr fixed_mat<T, R, K, maj>
+    operator *(fixed_mat<T, C, K, om> const& o) const noexcept {
+        fixed_mat<T, R, K, maj> m;
+        for (size_t r = 0; r < R; r++) for (size_t l = 0; l < C; l++) {
+            T a = elems[idx(r, l)];
+            for (size_t k = 0; k < K; k++) m.elems[m.idx(r, k)] += a * o.elems[o.idx(l, k)];
+        }
+        return m;
+    }
+    [[nodiscard]] constexpr fixed_vec<T, R> operator *(fixed_vec<T, C> const& v) const noexcept {
+        fixed_vec<T, R> y;
+        for (size_t r = 0; r < R; r++) for (size_t c = 0; c < C; c++)
+            y.elems[r] += elems[idx(r, c)] * v.elems[c];
+        return y;
+    }
+
+    [[nodiscard]] constexpr fixed_mat<T, C, R, maj> transposed() const noexcept {
+        fixed_mat<T, C, R, maj> m;
+        for (size_t r = 0; r < R; r++) for (size_t c = 0; c < C; c++)
+            m.elems[m.idx(c, r)] = elems[idx(r, c)];
+        return m;
+    }
+    /// --- end arithmetic ---
+};
+template<typename T, size_t R, size_t C> using fixed_col_mat = fixed_mat<T, R, C, mat_maj::col>;
+template<typename T, size_t R, size_t C> using fixed_row_mat = fixed_mat<T, R, C, mat_maj::row>;
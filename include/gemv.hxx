@@ -0,0 +1,118 @@
+#pragma once
+#include "mat.hxx"
+#include "owned_vec.hxx"
+#include "par.hxx"
+#include "simd.hxx"
+#include "tune.hxx"
+#include <vector>
+
+// Matrix-vector products y := alpha A x + beta y (gemv) and y := alpha A^T x + beta y (gemv_t).
+// Row-major A is traversed in dot-product form, one row at a time over column blocks of x
+// small enough to stay in cache; column-major A in axpy form, four columns at a time over
+// row blocks of y. Threads split the rows of y in both cases, so they never share output.
+// Strided x or y is packed into contiguous buffers first.
+struct gemv_kernel final {
+    template<typename S, typename AT, mat_maj maj, typename XT, typename YT>
+    static void run(S alpha, mat<AT, maj> a, XT const* x, S beta, YT* y) {
+        size_t m = a.n_rows(), n = a.n_cols();
+        // Columns of x (row-major) or rows of y (column-major) per cache block, and
+        // multiply-adds per thread below which no more threads are used.
+        size_t const block = tuned().gemv_block, par_grain = tuned().dense_grain;
+        AT const* ap = a.base_ptr();
+        auto scale = [&](size_t r, S v)
+            { y[r] = beta == S {} ? alpha * v : (alpha * v) + (beta * y[r]); };
+
+        par_for(m, std::max<size_t>(1, par_grain / (n + 1)), [&](size_t r0, size_t r1) {
+            std::vector<S> acc(std::min(block, r1 - r0));
+            if constexpr (maj == mat_maj::row) {
+                for (size_t rb = r0; rb < r1; rb += block) {
+                    size_t rn = std::min(block, r1 - rb);
+                    std::fill(acc.begin(), acc.begin() + rn, S {});
+                    for (size_t cb = 0; cb < n; cb += block) {
+                        size_t cn = std::min(block, n - cb);
+                        XT const* xb = x + cb;
+                        for (size_t r = 0; r < rn; r++) {
+                            AT const* ar = ap + ((rb + r) * n) + cb;
+                            acc[r] += lane_sum<S>(cn, [&](size_t c) { return ar[c] * xb[c]; });
+                        }
+                    }
+                    for (size_t r = 0; r < rn; r++) scale(rb + r, acc[r]);
+                }
+            } else {
+                for (size_t rb = r0; rb < r1; rb += block) {
+                    size_t rn = std::min(block, r1 - rb);
+                    S* yb = acc.data();
+                    std::fill(yb, yb + rn, S {});
+                    size_t c = 0;
+                    for (; c + 4 <= n; c += 4) {
+                        AT const* a0 = ap + (c * m) + rb;
+                        AT const* a1 = a0 + m, *a2 = a1 + m, *a3 = a2 + m;
+                        S x0 = x[c], x1 = x[c + 1], x2 = x[c + 2], x3 = x[c + 3];
+                        for (size_t r = 0; r < rn; r++)
+                            yb[r] += (a0[r] * x0) + (a1[r] * x1) + (a2[r] * x2) + (a3[r] * x3);
+                    }
+                    for (; c < n; c++) {
+                        AT const* a0 = ap + (c * m) + rb;
+                        S x0 = x[c];
+                        for (size_t r = 0; r < rn; r++) yb[r] += a0[r] * x0;
+                    }
+                    for (size_t r = 0; r < rn; r++) scale(rb + r, yb[r]);
+                }
+            }
+        });
+    }
+};
+
+/// --- products with length unsafety ---
+template<typename S, typename AT, mat_maj maj, typename XT, bool xhs, typename YT, bool yhs>
+    requires (!std::is_const_v<YT>)
+void gemv_nocklen(S alpha, mat<AT, maj> a, vec<XT, xhs> x, S beta, vec<YT, yhs> y) {
+    MATRIX_PROF_SCOPE("gemv", a.n_rows(), a.n_cols(),
+                      ((a.n_rows() * a.n_cols()) + x.len() + (2 * y.len())) * sizeof(AT),
+                      2 * a.n_rows() * a.n_cols());
+    using U = std::remove_const_t<XT>;
+    owned_vec<U>  xpack;
+    owned_vec<YT> ypack;
+    U const* xp = x.ptr();
+    YT*      yp = y.ptr();
+    if (x.stride() != 1) {
+        xpack = owned_vec<U>(x.len(), false);
+        xpack.copy_from_nocklen(x);
+        xp = xpack.ptr();
+    }
+    if (y.stride() != 1) {
+        ypack = owned_vec<YT>(y.len(), false);
+        ypack.copy_from_nocklen(y);
+        yp = ypack.ptr();
+    }
+    gemv_kernel::run(alpha, a, xp, beta, yp);
+    if (y.stride() != 1) y.copy_from_nocklen(ypack.as_const());
+}
+template<typename S, typename AT, mat_maj maj, typename XT, bool xhs, typename YT, bool yhs>
+    requires (!std::is_const_v<YT>)
+void gemv_t_nocklen(S alpha, mat<AT, maj> a, vec<XT, xhs> x, S beta, vec<YT, yhs> y)
+    { gemv_nocklen(alpha, a.transposed(), x, beta, y); }
+/// --- end products with length unsafety ---
+
+/// --- products ---
+template<typename S, typename AT, mat_maj maj, typename XT, bool xhs, typename YT, bool yhs>
+    requires (!std::is_const_v<YT>)
+void gemv(S alpha, mat<AT, maj> a, vec<XT, xhs> x, S beta, vec<YT, yhs> y) {
+    if (x.len() != a.n_cols()) throw vec_len_mismatch(a.n_cols(), x.len());
+    if (y.len() != a.n_rows()) throw vec_len_mismatch(a.n_rows(), y.len());
+    gemv_nocklen(alpha, a, x, beta, y);
+}
+template<typename S, typename AT, mat_maj maj, typename XT, bool xhs, typename YT, bool yhs>
+    requires (!std::is_const_v<YT>)
+void gemv_t(S alpha, mat<AT, maj> a, vec<XT, xhs> x, S beta, vec<YT, yhs> y)
+    { gemv(alpha, a.transposed(), x, beta, y); }
+
+template<typename AT, mat_maj maj, typename XT, bool xhs>
+[[nodiscard]] owned_vec<std::remove_const_t<AT>> operator *(mat<AT, maj> const& a,
+                                                           vec<XT, xhs> x) {
+    using U = std::remove_const_t<AT>;
+    owned_vec<U> y(a.n_rows(), false);
+    gemv(U {1}, a, x, U {}, y.as_ref());
+    return y;
+}
+/// --- end products ---
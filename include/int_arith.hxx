@@ -0,0 +1,169 @@
+#pragma once
+#include "checked_arith.hxx"
+#include "elementwise.hxx"
+#include <atomic>
+#include <limits>
+
+// Element-wise integer arithmetic z := x op y over vec and mat views, in one of three modes:
+// int_mode::wrap wraps modulo 2^bits (defined for signed types too), int_mode::saturate
+// clamps to the range of the type, and int_mode::check throws int_overflow. Every element is
+// computed branch-free together with an overflow flag, so all modes vectorize; the checked
+// mode ORs the flags over blocks of elements and tests them once per block, sharing its
+// block kernel with the checked array functions (checked_arith.hxx). It reports the
+// lowest overflowing index whatever the thread count, and the elements of z are then
+// unspecified from that index's block on in every part that overflowed.
+
+struct int_overflow : std::overflow_error {
+    int_overflow(size_t i) : std::overflow_error(mk_errmsg(i)) {}
+private:
+    static std::string mk_errmsg(size_t i) {
+        std::stringstream s;
+        s << "integer overflow in element " << i;
+        return s.str();
+    }
+};
+
+enum class int_mode { wrap, saturate, check };
+
+template<typename X, typename Y, typename T>
+concept int_operands = std::is_integral_v<T> && !std::is_const_v<T>
+                    && std::is_same_v<std::remove_const_t<X>, T>
+                    && std::is_same_v<std::remove_const_t<Y>, T>;
+
+struct int_kernel final {
+    static constexpr size_t block = int_flags::block;
+    static constexpr size_t none  = size_t(-1);
+
+    // z[i] := x[i] op y[i] for i in [0, n), stopping at the block of the first overflow in
+    // check mode. Returns first + the index of that overflow, none if there is none.
+    template<int_mode m, int_op op, typename T>
+    [[nodiscard]] static size_t run(size_t n, T const* x, size_t xs, T const* y, size_t ys,
+                                    T* z, size_t zs, size_t first) {
+        using ops = int_ops<T>;
+        using U   = std::make_unsigned_t<T>;
+        auto one = [](T a, T b, T& r) {
+            bool o;
+            r = ops::template apply<op>(a, b, o);
+            if constexpr (m == int_mode::saturate) r = o ? ops::template saturated<op>(a, b) : r;
+            return U(o);
+        };
+        for (size_t b0 = 0; b0 < n; b0 += block) {
+            size_t bn = std::min(block, n - b0);
+            T const* xb = x + (b0 * xs);
+            T const* yb = y + (b0 * ys);
+            T*       zb = z + (b0 * zs);
+            U any = xs == 1 && ys == 1 && zs == 1
+                  ? int_flags::any<U>(bn, [&](size_t i) { return one(xb[i], yb[i], zb[i]); })
+                  : int_flags::any<U>(bn, [&](size_t i) {
+                        return one(xb[i * xs], yb[i * ys], zb[i * zs]);
+                    });
+            if (m == int_mode::check && any) {
+                for (size_t i = 0; i < bn; i++) {
+                    bool o;
+                    (void)ops::template apply<op>(xb[i * xs], yb[i * ys], o);
+                    if (o) return first + b0 + i;
+                }
+            }
+        }
+        return none;
+    }
+
+    // Lowers lowest to i; the parts of a parallel loop share it to find the first overflow.
+    static void note(std::atomic<size_t>& lowest, size_t i) noexcept {
+        size_t cur = lowest.load(std::memory_order_relaxed);
+        while (i < cur && !lowest.compare_exchange_weak(cur, i, std::memory_order_relaxed)) {}
+    }
+    static void raise(std::atomic<size_t> const& lowest) {
+        if (size_t i = lowest.load(std::memory_order_relaxed); i != none) throw int_overflow(i);
+    }
+};
+
+/// --- vectors with length unsafety ---
+template<int_mode m, int_op op, typename XT, bool xhs, typename YT, bool yhs, typename T, bool zhs>
+    requires int_operands<XT, YT, T>
+void int_arith_nocklen(vec<XT, xhs> x, vec<YT, yhs> y, vec<T, zhs> z) {
+    size_t xs = x.stride(), ys = y.stride(), zs = z.stride();
+    std::atomic<size_t> lowest {int_kernel::none};
+    ewise_kernel::flat(x.len(), [&](size_t i0, size_t i1) {
+        int_kernel::note(lowest, int_kernel::run<m, op, T>(i1 - i0, x.ptr() + (i0 * xs), xs,
+                                                           y.ptr() + (i0 * ys), ys,
+                                                           z.ptr() + (i0 * zs), zs, i0));
+    });
+    int_kernel::raise(lowest);
+}
+/// --- end vectors with length unsafety ---
+
+/// --- vectors ---
+template<int_mode m, int_op op, typename XT, bool xhs, typename YT, bool yhs, typename T, bool zhs>
+    requires int_operands<XT, YT, T>
+void int_arith(vec<XT, xhs> x, vec<YT, yhs> y, vec<T, zhs> z) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    if (x.len() != z.len()) throw vec_len_mismatch(x.len(), z.len());
+    MATRIX_PROF_SCOPE("int_arith", x.len(), 1, 3 * x.len() * sizeof(T), x.len());
+    int_arith_nocklen<m, op>(x, y, z);
+}
+template<int_mode m = int_mode::wrap, typename XT, bool xhs, typename YT, bool yhs, typename T,
+         bool zhs>
+    requires int_operands<XT, YT, T>
+void int_add(vec<XT, xhs> x, vec<YT, yhs> y, vec<T, zhs> z) { int_arith<m, int_op::add>(x, y, z); }
+template<int_mode m = int_mode::wrap, typename XT, bool xhs, typename YT, bool yhs, typename T,
+         bool zhs>
+    requires int_operands<XT, YT, T>
+void int_sub(vec<XT, xhs> x, vec<YT, yhs> y, vec<T, zhs> z) { int_arith<m, int_op::sub>(x, y, z); }
+template<int_mode m = int_mode::wrap, typename XT, bool xhs, typename YT, bool yhs, typename T,
+         bool zhs>
+    requires int_operands<XT, YT, T>
+void int_mul(vec<XT, xhs> x, vec<YT, yhs> y, vec<T, zhs> z) { int_arith<m, int_op::mul>(x, y, z); }
+/// --- end vectors ---
+
+/// --- matrices with size unsafety ---
+// Walks c in its storage order; overflow indices count elements in that order.
+template<int_mode m, int_op op, typename AT, mat_maj am, typename BT, mat_maj bm, typename T,
+         mat_maj cm>
+    requires int_operands<AT, BT, T>
+void int_arith_nocklen(mat<AT, am> a, mat<BT, bm> b, mat<T, cm> c) {
+    if constexpr (am == cm && bm == cm) {
+        size_t n = c.n_rows() * c.n_cols();
+        int_arith_nocklen<m, op>(vec<AT, false>(a.base_ptr(), n), vec<BT, false>(b.base_ptr(), n),
+                                 vec<T, false>(c.base_ptr(), n));
+    } else {
+        auto [ao, ai] = ewise_kernel::walk<cm>(a);
+        auto [bo, bi] = ewise_kernel::walk<cm>(b);
+        size_t n = c.n_min();
+        std::atomic<size_t> lowest {int_kernel::none};
+        ewise_kernel::outer(c.n_maj(), n, [&](size_t i) {
+            int_kernel::note(lowest, int_kernel::run<m, op, T>(n, a.base_ptr() + (i * ao), ai,
+                                                               b.base_ptr() + (i * bo), bi,
+                                                               c.base_ptr() + (i * n), 1, i * n));
+        });
+        int_kernel::raise(lowest);
+    }
+}
+/// --- end matrices with size unsafety ---
+
+/// --- matrices ---
+template<int_mode m, int_op op, typename AT, mat_maj am, typename BT, mat_maj bm, typename T,
+         mat_maj cm>
+    requires int_operands<AT, BT, T>
+void int_arith(mat<AT, am> a, mat<BT, bm> b, mat<T, cm> c) {
+    if (a.n_rows() != b.n_rows() || a.n_cols() != b.n_cols())
+        throw mat_size_mismatch(a.n_rows(), a.n_cols(), b.n_rows(), b.n_cols());
+    if (a.n_rows() != c.n_rows() || a.n_cols() != c.n_cols())
+        throw mat_size_mismatch(a.n_rows(), a.n_cols(), c.n_rows(), c.n_cols());
+    MATRIX_PROF_SCOPE("int_arith", a.n_rows(), a.n_cols(), 3 * a.n_rows() * a.n_cols() * sizeof(T),
+                      a.n_rows() * a.n_cols());
+    int_arith_nocklen<m, op>(a, b, c);
+}
+template<int_mode m = int_mode::wrap, typename AT, mat_maj am, typename BT, mat_maj bm,
+         typename T, mat_maj cm>
+    requires int_operands<AT, BT, T>
+void int_add(mat<AT, am> a, mat<BT, bm> b, mat<T, cm> c) { int_arith<m, int_op::add>(a, b, c); }
+template<int_mode m = int_mode::wrap, typename AT, mat_maj am, typename BT, mat_maj bm,
+         typename T, mat_maj cm>
+    requires int_operands<AT, BT, T>
+void int_sub(mat<AT, am> a, mat<BT, bm> b, mat<T, cm> c) { int_arith<m, int_op::sub>(a, b, c); }
+template<int_mode m = int_mode::wrap, typename AT, mat_maj am, typename BT, mat_maj bm,
+         typename T, mat_maj cm>
+    requires int_operands<AT, BT, T>
+void int_mul(mat<AT, am> a, mat<BT, bm> b, mat<T, cm> c) { int_arith<m, int_op::mul>(a, b, c); }
+/// --- end matrices ---
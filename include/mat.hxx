@@ -1,5 +1,6 @@
 #pragma once
 #include "fwd.hxx"
+#include "prof.hxx"
 #include "vec.hxx"
 #include <cstring>
 #include <iostream>
@@ -82,7 +83,8 @@ protected:
 
     template<typename OT, mat_maj om>
     void assert_size_eq(mat<OT, om> o) const {
-        if (rows != o.rows || cols != o.cols) throw mat_size_mismatch(rows, cols, o.rows, o.cols);
+        if (rows != o.n_rows() || cols != o.n_cols())
+            throw mat_size_mismatch(rows, cols, o.n_rows(), o.n_cols());
     }
 
 public:
@@ -108,7 +110,7 @@ public:
 
     /// --- reinterpretation ---
     [[nodiscard]] mat<T, maj_transpose<maj>> transposed() const noexcept
-        { return mat(elems, rows, cols); }
+        { return mat<T, maj_transpose<maj>>(elems, cols, rows); }
     /// --- end reinterpretation ---
 
     /// --- accessors ---
@@ -136,17 +138,22 @@ public:
     // The m parameter can be used to match rows with rows or columns with columns
     // even when matrices differ in storage order.
     template<mat_maj m = maj>
-    [[nodiscard]] ::maj_vec<T, m> majvec(size_t i) const
-        { return matvecdisp<T, m>::majvec(*this, i); }
+    [[nodiscard]] auto majvec(size_t i) const {
+        if constexpr (m == maj) return matvecdisp<T, maj>::majvec(*this, i);
+        else                    return matvecdisp<T, maj>::minvec(*this, i);
+    }
     template<mat_maj m = maj>
-    [[nodiscard]] ::min_vec<T, m> minvec(size_t i) const
-        { return matvecdisp<T, m>::minvec(*this, i); }
+    [[nodiscard]] auto minvec(size_t i) const {
+        if constexpr (m == maj) return matvecdisp<T, maj>::minvec(*this, i);
+        else                    return matvecdisp<T, maj>::majvec(*this, i);
+    }
     /// --- end vector acquisition ---
 
     /// --- comparison ---
     template<typename OT, mat_maj om>
     bool operator ==(mat<OT, om> const& o) const noexcept {
-        if (rows != o.rows || cols != o.cols) return false;
+        if (rows != o.n_rows() || cols != o.n_cols()) return false;
+        MATRIX_PROF_SCOPE("mat.eq", rows, cols, rows * cols * (sizeof(T) + sizeof(OT)), 0);
         for (size_t i = 0; i < n_maj(); i++) {
             if (!majvec(i).eq_nocklen(o.template majvec<maj>(i))) return false;
         }
@@ -156,20 +163,28 @@ public:
 
     /// --- in-place modification ---
     template<typename OT, mat_maj om>
-    mat& add_assign_nocklen(mat<OT, om> const& o) requires is_mutable
-        { for (size_t i = 0; i < n_maj(); i++)majvec(i)+=o.template majvec<maj>(i);return *this; }
+    mat& add_assign_nocklen(mat<OT, om> const& o) requires is_mutable {
+        for (size_t i = 0; i < n_maj(); i++)
+            majvec(i).add_assign_nocklen(o.template majvec<maj>(i));
+        return *this;
+    }
     template<typename OT, mat_maj om>
-    mat& sub_assign_nocklen(mat<OT, om> const& o) requires is_mutable
-        { for (size_t i = 0; i < n_maj(); i++)majvec(i)-=o.template majvec<maj>(i);return *this; }
+    mat& sub_assign_nocklen(mat<OT, om> const& o) requires is_mutable {
+        for (size_t i = 0; i < n_maj(); i++)
+            majvec(i).sub_assign_nocklen(o.template majvec<maj>(i));
+        return *this;
+    }
 
     template<typename OT, mat_maj om>
     mat& operator +=(mat<OT, om> const& o) requires is_mutable {
         assert_size_eq(o);
+        MATRIX_PROF_SCOPE("mat.add_assign", rows, cols, 3 * rows * cols * sizeof(T), rows * cols);
         return add_assign_nocklen(o);
     }
     template<typename OT, mat_maj om>
     mat& operator -=(mat<OT, om> const& o) requires is_mutable {
         assert_size_eq(o);
+        MATRIX_PROF_SCOPE("mat.sub_assign", rows, cols, 3 * rows * cols * sizeof(T), rows * cols);
         return sub_assign_nocklen(o);
     }
 
@@ -181,7 +196,10 @@ public:
     }
     template<typename U = T, mat_maj om = maj>
     void copy_from(mat<U, om> const& o) const requires is_mutable {
-        if (o.rows < rows || o.cols < cols) throw mat_size_mismatch(rows, cols, o.rows, o.cols);
+        if (o.n_rows() < rows || o.n_cols() < cols)
+            throw mat_size_mismatch(rows, cols, o.n_rows(), o.n_cols());
+        // Across storage orders this is the library's transpose.
+        MATRIX_PROF_SCOPE("mat.copy_from", rows, cols, 2 * rows * cols * sizeof(T), 0);
         copy_from_nocklen(o);
     }
 
@@ -194,6 +212,7 @@ template<typename T> using row_mat = mat<T, mat_maj::row>;
 
 template<typename T, mat_maj maj>
 std::ostream& operator <<(std::ostream& o, mat<T, maj> const& m) {
+    MATRIX_PROF_SCOPE("mat.print", m.n_rows(), m.n_cols(), m.n_rows() * m.n_cols() * sizeof(T), 0);
     for (size_t r = 0; r < m.n_rows(); r++) {
         auto const& row = m[r];
         for (size_t c = 0; c < m.n_cols(); c++) {
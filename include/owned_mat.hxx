@@ -1,6 +1,8 @@
 #pragma once
+#include "alloc_stats.hxx"
 #include "checked_arith.hxx"
 #include "mat.hxx"
+#include "prof.hxx"
 
 template<typename T, mat_maj maj> requires (!std::is_const_v<T>)
 struct owned_mat final : mat<T, maj> {
@@ -14,6 +16,7 @@ struct owned_mat final : mat<T, maj> {
             throw std::runtime_error("matrix exceeds maximim size");
         }
         mat::elems = new T[num_cells]; // NOLINT, we own this
+        acct.on_alloc(num_cells * sizeof(T));
         if (zero_mem) mat::zero_fill();
     }
     void forget() noexcept { mat::elems = nullptr; mat::rows = mat::cols = 0; }
@@ -21,13 +24,18 @@ struct owned_mat final : mat<T, maj> {
     operator mat() && = delete;
 
     // Copy constructor
-    owned_mat(mat const& o) : owned_mat(o.n_rows(), o.n_cols(), false)
-        { memcpy(mat::elems, o.base_ptr(), o.n_rows() * o.n_cols() * sizeof(T)); }
+    owned_mat(mat const& o) : owned_mat(o.n_rows(), o.n_cols(), false) {
+        size_t bytes = o.n_rows() * o.n_cols() * sizeof(T);
+        MATRIX_PROF_SCOPE("mat.copy", o.n_rows(), o.n_cols(), 2 * bytes, 0);
+        memcpy(mat::elems, o.base_ptr(), bytes);
+    }
     owned_mat(owned_mat const& o) : owned_mat(static_cast<mat const&>(o)) {}
 
     // Copy assignment
     owned_mat& operator =(mat const& o) {
         if (mat::elems == o.base_ptr()) return *this;
+        MATRIX_PROF_SCOPE("mat.assign", o.n_rows(), o.n_cols(),
+                          2 * o.n_rows() * o.n_cols() * sizeof(T), 0);
         if (mat::rows < o.n_rows() || mat::cols < o.n_cols()) {
             fini();
             new(this) owned_mat(o.n_rows(), o.n_cols(), false);
@@ -41,17 +49,19 @@ struct owned_mat final : mat<T, maj> {
         { return *this = static_cast<mat const&>(o); } // NOLINT return *this
 
     template<typename U, mat_maj om>
-    void copy_from(::mat<U, om> const& o, bool zero_rest = true) &
-        { mat::template copy_from<T, maj>(o, zero_rest); }
+    void copy_from(::mat<U, om> const& o) &
+        { mat::template copy_from<U, om>(o); }
     template<typename U, mat_maj om>
     void copy_from(::mat<U, om> const& o) && = delete;
 
     // Move construction and assignment
-    owned_mat(owned_mat&& o) noexcept : mat(o.elems, o.rows, o.cols) { o.forget(); }
+    owned_mat(owned_mat&& o) noexcept : mat(o.elems, o.rows, o.cols)
+        { acct.take(o.acct); o.forget(); }
     owned_mat& operator =(owned_mat&& o) noexcept {
         if (this == &o) return *this;
         fini();
         new(this) mat(o.elems, o.rows, o.cols);
+        acct.take(o.acct);
         o.forget();
         return *this;
     }
@@ -62,6 +72,8 @@ struct owned_mat final : mat<T, maj> {
     template<typename OT, mat_maj om>
     owned_mat operator +(owned_mat<OT, om> const& o) const {
         mat::assert_size_eq(o);
+        MATRIX_PROF_SCOPE("mat.add", mat::rows, mat::cols,
+                          3 * mat::rows * mat::cols * sizeof(T), mat::rows * mat::cols);
         owned_mat rslt {*this};
         rslt.add_assign_nocklen(o);
         return rslt;
@@ -69,6 +81,8 @@ struct owned_mat final : mat<T, maj> {
     template<typename OT, mat_maj om>
     owned_mat operator -(owned_mat<OT, om> const& o) const {
         mat::assert_size_eq(o);
+        MATRIX_PROF_SCOPE("mat.sub", mat::rows, mat::cols,
+                          3 * mat::rows * mat::cols * sizeof(T), mat::rows * mat::cols);
         owned_mat rslt {*this};
         rslt.sub_assign_nocklen(o);
         return rslt;
@@ -76,7 +90,9 @@ struct owned_mat final : mat<T, maj> {
     /// --- end non-in-place arithmetic ---
 
 private:
-    void fini() { delete[] mat::elems; } // NOLINT gsl::owner
+    [[no_unique_address]] alloc_acct acct;
+
+    void fini() { acct.on_free(); delete[] mat::elems; } // NOLINT gsl::owner
 };
 template<typename T> using owned_col_mat = owned_mat<T, mat_maj::col>;
 template<typename T> using owned_row_mat = owned_mat<T, mat_maj::row>;
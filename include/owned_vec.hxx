@@ -1,5 +1,7 @@
 #pragma once
+#include "alloc_stats.hxx"
 #include "checked_arith.hxx"
+#include "prof.hxx"
 #include "vec.hxx"
 
 template<typename T>
@@ -15,6 +17,7 @@ public:
             throw std::runtime_error("matrix exceeds maximim size");
         }
         vec::_ptr = new T[len]; // NOLINT, we own this
+        acct.on_alloc(len * sizeof(T));
         if (zero_mem) vec::zero_fill();
     }
     void forget() noexcept { vec::_ptr = nullptr; vec::_len = 0; }
@@ -22,13 +25,16 @@ public:
     operator vec() && = delete;
 
     // Copy constructor
-    owned_vec(vec const& o) : owned_vec(o.len(), false)
-        { memcpy(vec::_ptr, o.ptr(), o.len() * sizeof(T)); }
+    owned_vec(vec const& o) : owned_vec(o.len(), false) {
+        MATRIX_PROF_SCOPE("vec.copy", o.len(), 1, 2 * o.len() * sizeof(T), 0);
+        memcpy(vec::_ptr, o.ptr(), o.len() * sizeof(T));
+    }
     owned_vec(owned_vec const& o) : owned_vec(static_cast<vec const&>(o)) {}
 
     // Copy assignment
     owned_vec& operator =(vec const& o) {
         if (vec::_ptr == o.ptr()) return *this;
+        MATRIX_PROF_SCOPE("vec.assign", o.len(), 1, 2 * o.len() * sizeof(T), 0);
         if (vec::_len < o.len()) {
             fini();
             new(this) owned_vec(o.len(), false);
@@ -47,22 +53,35 @@ public:
     void copy_from(::vec<U, ohs> const& o) && = delete;
 
     // Move construction and assignment
-    owned_vec(owned_vec&& o) noexcept : vec(o._ptr, o._len) { o.forget(); }
+    owned_vec(owned_vec&& o) noexcept : vec(o._ptr, o._len)
+        { acct.take(o.acct); o.forget(); }
     owned_vec& operator =(owned_vec&& o) noexcept {
         if (this == &o) return *this;
         fini();
         new(this) vec(o._ptr, o._len);
+        acct.take(o.acct);
         o.forget();
+        return *this;
     }
 
     ~owned_vec() { fini(); }
     /// --- end resource management ---
 
     /// --- non-in-place arithmetic ---
-    template<typename OT, bool ohs> owned_vec operator +(::vec<OT, ohs> o) const
-        { owned_vec rslt = *this; rslt += o; return rslt; }
-    template<typename OT, bool ohs> owned_vec operator -(::vec<OT, ohs> o) const
-        { owned_vec rslt = *this; rslt -= o; return rslt; }
+    template<typename OT, bool ohs> owned_vec operator +(::vec<OT, ohs> o) const {
+        vec::assert_len_eq(o);
+        MATRIX_PROF_SCOPE("vec.add", vec::_len, 1, 3 * vec::_len * sizeof(T), vec::_len);
+        owned_vec rslt = *this;
+        rslt.add_assign_nocklen(o);
+        return rslt;
+    }
+    template<typename OT, bool ohs> owned_vec operator -(::vec<OT, ohs> o) const {
+        vec::assert_len_eq(o);
+        MATRIX_PROF_SCOPE("vec.sub", vec::_len, 1, 3 * vec::_len * sizeof(T), vec::_len);
+        owned_vec rslt = *this;
+        rslt.sub_assign_nocklen(o);
+        return rslt;
+    }
 
     owned_vec operator +(T v) const { owned_vec rslt = *this; rslt += v; return rslt; }
     owned_vec operator -(T v) const { owned_vec rslt = *this; rslt -= v; return rslt; }
@@ -74,5 +93,7 @@ public:
     /// --- end non-in-place arithmetic ---
 
 private:
-    void fini() { delete[] vec::_ptr; } // NOLINT gsl::owner
+    [[no_unique_address]] alloc_acct acct;
+
+    void fini() { acct.on_free(); delete[] vec::_ptr; } // NOLINT gsl::owner
 };
@@ -0,0 +1,130 @@
+#pragma once
+#include "alloc_stats.hxx"
+#include "perf.hxx"
+#include "simd.hxx"
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// --- worker count ---
+inline size_t& par_threads_ref() noexcept {
+    static size_t n = std::max(1U, std::thread::hardware_concurrency());
+    return n;
+}
+[[nodiscard]] inline size_t par_threads() noexcept { return par_threads_ref(); }
+// Passing 0 restores the hardware default.
+inline void set_par_threads(size_t n) noexcept
+    { par_threads_ref() = n ? n : std::max(1U, std::thread::hardware_concurrency()); }
+/// --- end worker count ---
+
+/// --- reproducibility ---
+// When set, parallel reductions fix their reduction tree independently of par_threads(),
+// so their results are bitwise identical for any thread count (for one build: the lane
+// counts of lane_fold follow the target's vector width).
+inline bool& par_reproducible_ref() noexcept { static bool r = false; return r; }
+[[nodiscard]] inline bool par_reproducible() noexcept { return par_reproducible_ref(); }
+inline void set_par_reproducible(bool r) noexcept { par_reproducible_ref() = r; }
+/// --- end reproducibility ---
+
+/// --- parallel loops ---
+// Set on worker threads so that nested parallel loops run serially.
+inline bool& par_nested() noexcept { thread_local bool nested = false; return nested; }
+
+// Runs fn(p) for every p in [0, parts), the calling thread taking p = 0.
+// The first exception thrown by any part is rethrown after all parts finish.
+// Workers allocate under the calling thread's alloc tag and count toward its open perf_scope.
+template<typename F>
+void par_invoke(size_t parts, F&& fn) {
+    if (parts <= 1 || par_nested()) { for (size_t p = 0; p < parts; p++) fn(p); return; }
+
+    std::exception_ptr err;
+    std::mutex         err_mtx;
+    perf_scope*        scope = perf_scope::current();
+    char const*        tag   = alloc_tag_current();
+    auto run = [&](size_t p) {
+        bool was_nested = std::exchange(par_nested(), true);
+        try { alloc_tag_scope t(tag); perf_worker w(p ? scope : nullptr); fn(p); }
+        catch (...) { std::lock_guard lk(err_mtx); if (!err) err = std::current_exception(); }
+        par_nested() = was_nested;
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(parts - 1);
+    for (size_t p = 1; p < parts; p++) workers.emplace_back(run, p);
+    run(0);
+    for (auto& w : workers) w.join();
+    if (err) std::rethrow_exception(err);
+}
+
+// Runs fn(begin, end) over consecutive parts of [0, n) no shorter than grain,
+// using at most par_threads() threads.
+template<typename F>
+void par_for(size_t n, size_t grain, F&& fn) {
+    grain = std::max<size_t>(grain, 1);
+    size_t parts = std::min(par_threads(), (n + grain - 1) / grain);
+    if (parts <= 1 || par_nested()) { if (n) fn(size_t {0}, n); return; }
+    par_invoke(parts, [&](size_t p) { fn(n * p / parts, n * (p + 1) / parts); });
+}
+
+// Like par_for, but balances the parts by weight instead of item count:
+// item i weighs prefix[i + 1] - prefix[i] and every part but the last weighs at least grain.
+template<typename F>
+void par_for_balanced(size_t n, size_t const* prefix, size_t grain, F&& fn) {
+    size_t total = prefix[n] - prefix[0];
+    size_t parts = std::min(par_threads(), total / std::max<size_t>(grain, 1));
+    if (parts <= 1 || par_nested()) { if (n) fn(size_t {0}, n); return; }
+
+    std::vector<size_t> bounds(parts + 1);
+    for (size_t p = 1; p < parts; p++) {
+        size_t target = prefix[0] + (total * p / parts);
+        bounds[p] = std::lower_bound(prefix, prefix + n, target) - prefix;
+    }
+    bounds[parts] = n;
+    par_invoke(parts, [&](size_t p) { if (bounds[p] < bounds[p + 1]) fn(bounds[p], bounds[p + 1]); });
+}
+
+// Reproducible variant of par_reduce: [0, n) is cut into blocks of a fixed size whatever
+// the thread count, every block is folded with lane_fold and the block results are combined
+// in a fixed pairwise tree. Threads only decide who folds which blocks.
+template<typename R, size_t L = 2 * simd_lanes<R>, typename Op, typename F>
+[[nodiscard]] R par_reduce_fixed(size_t n, size_t grain, R init, Op&& op, F&& f) {
+    constexpr size_t block = 4096;
+    if (n == 0) return init;
+    size_t nb = (n + block - 1) / block;
+    std::vector<R> part(nb);
+    par_for(nb, std::max<size_t>(1, grain / block), [&](size_t b0, size_t b1) {
+        for (size_t b = b0; b < b1; b++) {
+            size_t i0 = b * block;
+            part[b] = lane_fold<R, L>(std::min(block, n - i0), op,
+                                      [&](size_t i) { return f(i0 + i); });
+        }
+    });
+    for (size_t w = 1; w < nb; w *= 2)
+        for (size_t b = 0; b + w < nb; b += 2 * w) part[b] = op(part[b], part[b + w]);
+    return op(init, part[0]);
+}
+
+// Folds f(i) over [0, n) with op, starting from init, in parts no shorter than grain on at
+// most par_threads() threads. Every part is folded with lane_fold and the parts are combined
+// in index order, so the result depends on the thread count but never on scheduling;
+// with par_reproducible() set, par_reduce_fixed takes over and it does not depend on either.
+template<typename R, size_t L = 2 * simd_lanes<R>, typename Op, typename F>
+[[nodiscard]] R par_reduce(size_t n, size_t grain, R init, Op&& op, F&& f) {
+    if (par_reproducible()) return par_reduce_fixed<R, L>(n, grain, init, op, f);
+    if (n == 0) return init;
+    size_t parts = std::clamp<size_t>(n / std::max<size_t>(grain, 1), 1, par_threads());
+    if (parts == 1 || par_nested()) return op(init, lane_fold<R, L>(n, op, f));
+
+    std::vector<R> part(parts);
+    par_invoke(parts, [&](size_t p) {
+        size_t i0 = n * p / parts;
+        part[p] = lane_fold<R, L>(n * (p + 1) / parts - i0, op,
+                                  [&](size_t i) { return f(i0 + i); });
+    });
+    for (auto const& r : part) init = op(init, r);
+    return init;
+}
+/// --- end parallel loops ---
@@ -0,0 +1,232 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters per call site. Library operations are wrapped in
+// MATRIX_PROF_SCOPE (prof.hxx); with MATRIX_PERF_COUNTERS defined, every scope adds the
+// cycles, instructions, last-level cache misses, wall time, bytes moved and flops done by
+// its call to the totals of its site. Counters come from perf_event_open
+// on the calling thread and stay zero where it is unavailable (other systems, or
+// perf_event_paranoid too strict); calls, bytes and time are counted regardless.
+// par_invoke workers count their own threads and add the deltas to the scope open on
+// the thread that started them, so parallel kernels are counted in full.
+
+/// --- site statistics ---
+struct perf_stats final {
+    uint64_t calls        {};
+    uint64_t cycles       {};
+    uint64_t instructions {};
+    uint64_t llc_misses   {};
+    uint64_t bytes        {};
+    uint64_t flops        {};
+    uint64_t ns           {};
+
+    perf_stats& operator +=(perf_stats const& o) noexcept {
+        calls += o.calls; cycles += o.cycles; instructions += o.instructions;
+        llc_misses += o.llc_misses; bytes += o.bytes; flops += o.flops; ns += o.ns;
+        return *this;
+    }
+    [[nodiscard]] double ipc() const noexcept
+        { return cycles ? double(instructions) / double(cycles) : 0; }
+    [[nodiscard]] double bytes_per_cycle() const noexcept
+        { return cycles ? double(bytes) / double(cycles) : 0; }
+    [[nodiscard]] double gbps() const noexcept { return ns ? double(bytes) / double(ns) : 0; }
+    [[nodiscard]] double gflops() const noexcept { return ns ? double(flops) / double(ns) : 0; }
+    // Flops per byte moved.
+    [[nodiscard]] double intensity() const noexcept
+        { return bytes ? double(flops) / double(bytes) : 0; }
+};
+
+struct perf_registry final {
+    [[nodiscard]] static perf_registry& get() { static perf_registry r; return r; }
+
+    void add(char const* site, perf_stats const& s) {
+        std::lock_guard lk(mtx);
+        sites[site] += s;
+    }
+    [[nodiscard]] perf_stats at(std::string const& site) const {
+        std::lock_guard lk(mtx);
+        auto it = sites.find(site);
+        return it == sites.end() ? perf_stats {} : it->second;
+    }
+    [[nodiscard]] std::map<std::string, perf_stats> snapshot() const {
+        std::lock_guard lk(mtx);
+        return sites;
+    }
+    void reset() { std::lock_guard lk(mtx); sites.clear(); }
+
+    void dump_json(std::ostream& o) const {
+        auto snap = snapshot();
+        o << "{";
+        bool first = true;
+        for (auto const& [site, s] : snap) {
+            o << (first ? "\n" : ",\n") << "  \"" << site << "\": {\"calls\": " << s.calls
+              << ", \"cycles\": " << s.cycles << ", \"instructions\": " << s.instructions
+              << ", \"llc_misses\": " << s.llc_misses << ", \"bytes\": " << s.bytes
+              << ", \"flops\": " << s.flops << ", \"ns\": " << s.ns
+              << ", \"ipc\": " << s.ipc() << '}';
+            first = false;
+        }
+        o << "\n}\n";
+    }
+
+private:
+    mutable std::mutex                mtx;
+    std::map<std::string, perf_stats> sites;
+};
+/// --- end site statistics ---
+
+/// --- counters ---
+// One counter group per thread: cycles (the leader), instructions and cache misses.
+struct perf_counters final {
+    static constexpr size_t n_events = 3;
+
+    [[nodiscard]] static perf_counters& this_thread() {
+        thread_local perf_counters c;
+        return c;
+    }
+    [[nodiscard]] bool available() const noexcept { return fds[0] >= 0; }
+
+    // Current counts, all zero when unavailable.
+    void read(uint64_t (&out)[n_events]) const noexcept {
+        for (auto& v : out) v = 0;
+#if defined(__linux__)
+        if (!available()) return;
+        uint64_t buf[1 + n_events] {}; // PERF_FORMAT_GROUP: count, then values
+        if (::read(fds[0], buf, sizeof(buf)) < ssize_t(sizeof(uint64_t))) return;
+        for (size_t i = 0; i < n_events && i < buf[0]; i++) out[i] = buf[1 + i];
+#endif
+    }
+
+    perf_counters(perf_counters const&) = delete;
+    perf_counters& operator =(perf_counters const&) = delete;
+    ~perf_counters() {
+#if defined(__linux__)
+        for (int fd : fds) if (fd >= 0) ::close(fd);
+#endif
+    }
+
+private:
+    int fds[n_events] {-1, -1, -1};
+
+    perf_counters() {
+#if defined(__linux__)
+        uint64_t const cfg[n_events] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        };
+        for (size_t i = 0; i < n_events; i++) {
+            perf_event_attr a {};
+            a.size           = sizeof(a);
+            a.type           = PERF_TYPE_HARDWARE;
+            a.config         = cfg[i];
+            a.read_format    = PERF_FORMAT_GROUP;
+            a.disabled       = i == 0 ? 1 : 0;
+            a.exclude_kernel = 1;
+            a.exclude_hv     = 1;
+            int group = i == 0 ? -1 : fds[0];
+            fds[i] = int(::syscall(SYS_perf_event_open, &a, 0, -1, group, 0));
+            if (fds[i] < 0) { close_all(); return; }
+        }
+        ::ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+    void close_all() noexcept {
+#if defined(__linux__)
+        for (int& fd : fds) { if (fd >= 0) ::close(fd); fd = -1; }
+#endif
+    }
+};
+
+[[nodiscard]] inline bool perf_counters_available()
+    { return perf_counters::this_thread().available(); }
+/// --- end counters ---
+
+/// --- scopes ---
+// Adds the counts between its construction and destruction to site, a string literal.
+struct perf_scope final {
+    perf_scope(char const* site, uint64_t bytes, uint64_t flops = 0)
+        : site(site), bytes(bytes), flops(flops), ctr(perf_counters::this_thread()),
+          outer(std::exchange(current(), this)) {
+        ctr.read(start);
+        t0 = std::chrono::steady_clock::now();
+    }
+    ~perf_scope() {
+        auto     t1 = std::chrono::steady_clock::now();
+        uint64_t end[perf_counters::n_events];
+        ctr.read(end);
+        current() = outer;
+        perf_registry::get().add(site, {
+            .calls        = 1,
+            .cycles       = end[0] - start[0] + workers[0].load(std::memory_order_relaxed),
+            .instructions = end[1] - start[1] + workers[1].load(std::memory_order_relaxed),
+            .llc_misses   = end[2] - start[2] + workers[2].load(std::memory_order_relaxed),
+            .bytes        = bytes,
+            .flops        = flops,
+            .ns           = uint64_t(std::chrono::nanoseconds(t1 - t0).count()),
+        });
+    }
+    perf_scope(perf_scope const&) = delete;
+    perf_scope& operator =(perf_scope const&) = delete;
+
+    // Innermost scope open on this thread, null if none.
+    [[nodiscard]] static perf_scope*& current() noexcept {
+        thread_local perf_scope* s = nullptr;
+        return s;
+    }
+    [[nodiscard]] bool counting() const noexcept { return ctr.available(); }
+
+    // Work only known once the scope has run, e.g. iterations of a solver.
+    void add(uint64_t more_bytes, uint64_t more_flops) noexcept
+        { bytes += more_bytes; flops += more_flops; }
+    // Counts of other threads working for this scope; safe to call concurrently.
+    void add_counts(uint64_t const (&delta)[perf_counters::n_events]) noexcept {
+        for (size_t i = 0; i < perf_counters::n_events; i++)
+            workers[i].fetch_add(delta[i], std::memory_order_relaxed);
+    }
+
+private:
+    char const*                           site;
+    uint64_t                              bytes;
+    uint64_t                              flops;
+    perf_counters&                        ctr;
+    perf_scope*                           outer;
+    uint64_t                              start[perf_counters::n_events] {};
+    std::atomic<uint64_t>                 workers[perf_counters::n_events] {};
+    std::chrono::steady_clock::time_point t0;
+};
+
+// Adds the counts of this thread over its lifetime to into, a scope open on another
+// thread. Does nothing for a null scope or one without counters, so workers only open
+// counters (3 descriptors, closed when the thread exits) when they are read.
+struct perf_worker final {
+    explicit perf_worker(perf_scope* into) : into(into && into->counting() ? into : nullptr)
+        { if (this->into) perf_counters::this_thread().read(start); }
+    ~perf_worker() {
+        if (!into) return;
+        uint64_t end[perf_counters::n_events];
+        perf_counters::this_thread().read(end);
+        for (size_t i = 0; i < perf_counters::n_events; i++) end[i] -= start[i];
+        into->add_counts(end);
+    }
+    perf_worker(perf_worker const&) = delete;
+    perf_worker& operator =(perf_worker const&) = delete;
+
+private:
+    perf_scope* into;
+    uint64_t    start[perf_counters::n_events] {};
+};
+/// --- end scopes ---
@@ -0,0 +1,41 @@
+#pragma once
+#include "perf.hxx"
+#include "trace.hxx"
+
+// The one hook library operations are instrumented with:
+//     MATRIX_PROF_SCOPE(site, rows, cols, bytes, flops);
+// opens, for the rest of the enclosing block, a hardware counter scope when
+// MATRIX_PERF_COUNTERS is defined and a trace scope when MATRIX_TRACE is defined.
+// With neither, it expands to nothing and its arguments are not evaluated.
+// MATRIX_PROF_SCOPE_AS(name, site, ...) opens the same scopes under a name, so that work
+// only known at the end of the block can be added with MATRIX_PROF_ADD(name, bytes, flops).
+
+#define MATRIX_PROF_CAT_(a, b) a##b
+#define MATRIX_PROF_CAT(a, b)  MATRIX_PROF_CAT_(a, b)
+
+#if defined(MATRIX_PERF_COUNTERS)
+#define MATRIX_PROF_PERF_(name, site, bytes, flops) \
+    perf_scope MATRIX_PROF_CAT(name, _perf)((site), (bytes), (flops))
+#define MATRIX_PROF_PERF_ADD_(name, bytes, flops) MATRIX_PROF_CAT(name, _perf).add((bytes), (flops))
+#else
+#define MATRIX_PROF_PERF_(name, site, bytes, flops) ((void)0)
+#define MATRIX_PROF_PERF_ADD_(name, bytes, flops) ((void)0)
+#endif
+
+#if defined(MATRIX_TRACE)
+#define MATRIX_PROF_TRACE_(name, site, rows, cols, bytes, flops) \
+    trace_scope MATRIX_PROF_CAT(name, _trace)((site), (rows), (cols), (bytes), (flops))
+#define MATRIX_PROF_TRACE_ADD_(name, bytes, flops) \
+    MATRIX_PROF_CAT(name, _trace).add((bytes), (flops))
+#else
+#define MATRIX_PROF_TRACE_(name, site, rows, cols, bytes, flops) ((void)0)
+#define MATRIX_PROF_TRACE_ADD_(name, bytes, flops) ((void)0)
+#endif
+
+#define MATRIX_PROF_SCOPE_AS(name, site, rows, cols, bytes, flops) \
+    MATRIX_PROF_PERF_(name, site, bytes, flops); \
+    MATRIX_PROF_TRACE_(name, site, rows, cols, bytes, flops)
+#define MATRIX_PROF_SCOPE(site, rows, cols, bytes, flops) \
+    MATRIX_PROF_SCOPE_AS(MATRIX_PROF_CAT(prof_, __LINE__), site, rows, cols, bytes, flops)
+#define MATRIX_PROF_ADD(name, bytes, flops) \
+    MATRIX_PROF_PERF_ADD_(name, bytes, flops); MATRIX_PROF_TRACE_ADD_(name, bytes, flops)
@@ -0,0 +1,364 @@
+#pragma once
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include "par.hxx"
+#include "tune.hxx"
+#include <cmath>
+#include <optional>
+#include <vector>
+
+struct qr_too_wide : std::invalid_argument {
+    qr_too_wide(size_t rows, size_t cols) : std::invalid_argument(mk_errmsg(rows, cols)) {}
+private:
+    static std::string mk_errmsg(size_t rows, size_t cols) {
+        std::stringstream s;
+        s << "QR factorization of a " << rows << 'x' << cols << " matrix needs rows >= cols";
+        return s.str();
+    }
+};
+struct qr_rank_deficient : std::runtime_error {
+    qr_rank_deficient(size_t col) : std::runtime_error(mk_errmsg(col)) {}
+private:
+    static std::string mk_errmsg(size_t col) {
+        std::stringstream s;
+        s << "matrix is rank deficient (zero diagonal of R in column " << col << ')';
+        return s.str();
+    }
+};
+
+template<typename T> struct tsqr_fact;
+
+// Householder QR of an m x n matrix takes 2mn^2 - 2n^3/3 flops.
+[[nodiscard]] inline size_t qr_flops(size_t m, size_t n) noexcept
+    { return (2 * m * n * n) - (2 * n * n * n / 3); }
+
+// Blocked Householder QR of a column-major matrix, A = QR.
+// Q is kept as the reflectors below the diagonal plus one compact WY factor
+// (Q_k = I - V T V^T) per block of `block` columns.
+template<typename T>
+struct qr_fact final {
+    static_assert(std::is_floating_point_v<T>);
+
+protected:
+    friend tsqr_fact<T>;
+
+    /// --- fields ---
+    owned_col_mat<T> qr;    // R on and above the diagonal, reflectors below it
+    owned_vec<T>     tau;   // scalar factors of the reflectors
+    owned_col_mat<T> tfac;  // T factors, block k in rows 0..kb, columns k..k+kb
+    size_t           block;
+    /// --- end fields ---
+
+public:
+    /// --- constructors ---
+    explicit qr_fact(owned_col_mat<T>&& a, size_t block = tuned().qr_block)
+        : qr(std::move(a)), tau(qr.n_cols()), tfac(std::max<size_t>(block, 1), qr.n_cols()),
+          block(std::max<size_t>(block, 1)) {
+        if (qr.n_rows() < qr.n_cols()) throw qr_too_wide(qr.n_rows(), qr.n_cols());
+        MATRIX_PROF_SCOPE("qr", qr.n_rows(), qr.n_cols(), qr.n_rows() * qr.n_cols() * sizeof(T),
+                          qr_flops(qr.n_rows(), qr.n_cols()));
+        factor();
+    }
+    explicit qr_fact(col_mat<T const> a, size_t block = tuned().qr_block)
+        : qr_fact(copy_of(a), block) {}
+    /// --- end constructors ---
+
+    /// --- accessors ---
+    [[nodiscard]] size_t n_rows() const noexcept { return qr.n_rows(); }
+    [[nodiscard]] size_t n_cols() const noexcept { return qr.n_cols(); }
+
+    [[nodiscard]] owned_col_mat<T> r() const {
+        size_t n = n_cols();
+        owned_col_mat<T> rslt(n, n);
+        for (size_t j = 0; j < n; j++) memcpy(rslt.col_ptr(j), qr.col_ptr(j), (j + 1) * sizeof(T));
+        return rslt;
+    }
+    /// --- end accessors ---
+
+    /// --- application of Q ---
+    // b := Q^T b
+    void apply_qt(col_mat<T> b) const {
+        assert_rows_eq(b);
+        for (size_t k = 0; k < n_cols(); k += block)
+            apply_block(k, std::min(block, n_cols() - k), b.base_ptr(), b.n_cols(), true);
+    }
+    // b := Q b
+    void apply_q(col_mat<T> b) const {
+        assert_rows_eq(b);
+        if (n_cols() == 0) return;
+        for (size_t k = (n_cols() - 1) / block * block;; k -= block) {
+            apply_block(k, std::min(block, n_cols() - k), b.base_ptr(), b.n_cols(), false);
+            if (k == 0) break;
+        }
+    }
+    /// --- end application of Q ---
+
+    /// --- least squares ---
+    // Minimizes ||Ax - b||.
+    template<typename OT, bool ohs>
+    [[nodiscard]] owned_vec<T> solve(vec<OT, ohs> b) const {
+        if (b.len() != n_rows()) throw vec_len_mismatch(n_rows(), b.len());
+        owned_vec<T> qtb(n_rows(), false);
+        for (size_t i = 0; i < qtb.len(); i++) qtb.ptr()[i] = b.ptr()[i * b.stride()];
+        apply_qt(col_mat<T>(qtb.ptr(), qtb.len(), 1));
+        owned_vec<T> x(n_cols(), false);
+        memcpy(x.ptr(), qtb.ptr(), n_cols() * sizeof(T));
+        back_substitute(x.ptr());
+        return x;
+    }
+    /// --- end least squares ---
+
+private:
+    static owned_col_mat<T> copy_of(col_mat<T const> a) {
+        owned_col_mat<T> rslt(a.n_rows(), a.n_cols(), false);
+        memcpy(rslt.base_ptr(), a.base_ptr(), a.n_rows() * a.n_cols() * sizeof(T));
+        return rslt;
+    }
+    void assert_rows_eq(col_mat<T> b) const {
+        if (b.n_rows() != n_rows()) throw mat_size_mismatch(n_rows(), n_cols(), b.n_rows(), b.n_cols());
+    }
+
+    [[nodiscard]] T*       col(size_t j)       noexcept { return qr.col_ptr(j); }
+    [[nodiscard]] T const* col(size_t j) const noexcept { return qr.col_ptr(j); }
+    [[nodiscard]] T&       tf (size_t i, size_t j) const noexcept { return tfac.col_ptr(j)[i]; }
+
+    // Overflow-safe Euclidean norm.
+    static T nrm2(T const* x, size_t n) noexcept {
+        T scale {}, ssq = 1;
+        for (size_t i = 0; i < n; i++) {
+            T a = std::abs(x[i]);
+            if (a == 0) continue;
+            if (scale < a) { ssq = 1 + (ssq * (scale / a) * (scale / a)); scale = a; }
+            else ssq += (a / scale) * (a / scale);
+        }
+        return scale * std::sqrt(ssq);
+    }
+
+    // Turns v into the reflector H = I - tau u u^T with Hv = (beta, 0, ...);
+    // beta is stored in v[0], u[1..] in v[1..] and u[0] = 1 is implied.
+    static T make_reflector(T* v, size_t len) noexcept {
+        T xnorm = nrm2(v + 1, len - 1);
+        if (xnorm == 0) return 0;
+        T alpha = v[0];
+        T beta  = -std::copysign(std::hypot(alpha, xnorm), alpha);
+        T scal  = 1 / (alpha - beta);
+        for (size_t i = 1; i < len; i++) v[i] *= scal;
+        v[0] = beta;
+        return (beta - alpha) / beta;
+    }
+    // c := (I - tau u u^T) c with u[0] = 1.
+    static void apply_reflector(T const* u, size_t len, T tau, T* c) noexcept {
+        if (tau == 0) return;
+        T w = c[0];
+        for (size_t i = 1; i < len; i++) w += u[i] * c[i];
+        w *= tau;
+        c[0] -= w;
+        for (size_t i = 1; i < len; i++) c[i] -= w * u[i];
+    }
+
+    void factor() {
+        size_t m = n_rows(), n = n_cols();
+        for (size_t k = 0; k < n; k += block) {
+            size_t kb = std::min(block, n - k);
+            for (size_t j = k; j < k + kb; j++) {
+                T* u = col(j) + j;
+                tau.ptr()[j] = make_reflector(u, m - j);
+                T beta = u[0];
+                u[0] = 1;
+                for (size_t c = j + 1; c < k + kb; c++)
+                    apply_reflector(u, m - j, tau.ptr()[j], col(c) + j);
+                u[0] = beta;
+            }
+            build_t(k, kb);
+            if (k + kb < n) apply_block(k, kb, col(k + kb), n - k - kb, true);
+        }
+    }
+
+    // Forms the upper triangular T of the block of reflectors k..k+kb.
+    void build_t(size_t k, size_t kb) noexcept {
+        size_t m = n_rows();
+        for (size_t i = 0; i < kb; i++) {
+            T ti = tau.ptr()[k + i];
+            T const* ui = col(k + i) + k;
+            for (size_t l = 0; l < i; l++) {
+                T const* ul = col(k + l) + k;
+                T w = ul[i];
+                for (size_t r = i + 1; r < m - k; r++) w += ul[r] * ui[r];
+                tf(l, k + i) = -ti * w;
+            }
+            for (size_t r = 0; r < i; r++) {
+                T w {};
+                for (size_t l = r; l < i; l++) w += tf(r, k + l) * tf(l, k + i);
+                tf(r, k + i) = w;
+            }
+            tf(i, k + i) = ti;
+        }
+    }
+
+    // c := (I - V T' V^T) c on rows k.. of a column-major block with n_rows() rows,
+    // where T' is T^T when trans is set and T otherwise.
+    void apply_block(size_t k, size_t kb, T* c, size_t ncols, bool trans) const {
+        size_t m = n_rows(), len = m - k;
+        par_for(ncols, std::max<size_t>(1, (1 << 16) / (len * kb + 1)), [&](size_t c0, size_t c1) {
+            std::vector<T> w(kb);
+            for (size_t cc = c0; cc < c1; cc++) {
+                T* cv = c + (cc * m) + k;
+                for (size_t j = 0; j < kb; j++) {
+                    T const* u = col(k + j) + k;
+                    T s = cv[j];
+                    for (size_t i = j + 1; i < len; i++) s += u[i] * cv[i];
+                    w[j] = s;
+                }
+                if (trans) {
+                    for (size_t i = kb; i-- > 0;) {
+                        T s {};
+                        for (size_t l = 0; l <= i; l++) s += tf(l, k + i) * w[l];
+                        w[i] = s;
+                    }
+                } else {
+                    for (size_t i = 0; i < kb; i++) {
+                        T s {};
+                        for (size_t l = i; l < kb; l++) s += tf(i, k + l) * w[l];
+                        w[i] = s;
+                    }
+                }
+                for (size_t j = 0; j < kb; j++) {
+                    T const* u = col(k + j) + k;
+                    T wj = w[j];
+                    cv[j] -= wj;
+                    for (size_t i = j + 1; i < len; i++) cv[i] -= u[i] * wj;
+                }
+            }
+        });
+    }
+
+    // Solves Rx = x in place.
+    void back_substitute(T* x) const {
+        for (size_t j = n_cols(); j-- > 0;) {
+            T d = col(j)[j];
+            if (d == 0) throw qr_rank_deficient(j);
+            x[j] /= d;
+            T const* rj = col(j);
+            for (size_t i = 0; i < j; i++) x[i] -= rj[i] * x[j];
+        }
+    }
+};
+
+// Communication-avoiding QR of a tall-skinny matrix: row blocks are factored
+// in parallel and their R factors are merged pairwise up a binary tree.
+template<typename T>
+struct tsqr_fact final {
+    static_assert(std::is_floating_point_v<T>);
+
+protected:
+    /// --- fields ---
+    size_t                                         rows, cols;
+    std::vector<size_t>                            offs;   // first row of each leaf block
+    std::vector<std::optional<qr_fact<T>>>         leaves;
+    std::vector<std::vector<std::optional<qr_fact<T>>>> levels; // empty entries pass through
+    /// --- end fields ---
+
+public:
+    /// --- constructors ---
+    explicit tsqr_fact(col_mat<T const> a, size_t n_blocks = par_threads(),
+                       size_t block = tuned().qr_block)
+        : rows(a.n_rows()), cols(a.n_cols()) {
+        if (rows < cols) throw qr_too_wide(rows, cols);
+        MATRIX_PROF_SCOPE("tsqr", rows, cols, rows * cols * sizeof(T), qr_flops(rows, cols));
+        n_blocks = std::clamp<size_t>(n_blocks, 1, cols ? rows / cols : 1);
+        for (size_t b = 0; b <= n_blocks; b++) offs.push_back(rows * b / n_blocks);
+
+        leaves.resize(n_blocks);
+        par_for(n_blocks, 1, [&](size_t b0, size_t b1) {
+            for (size_t b = b0; b < b1; b++) {
+                size_t r0 = offs[b], h = offs[b + 1] - r0;
+                owned_col_mat<T> part(h, cols, false);
+                for (size_t j = 0; j < cols; j++)
+                    memcpy(part.col_ptr(j), a.col_ptr(j) + r0, h * sizeof(T));
+                leaves[b].emplace(std::move(part), block);
+            }
+        });
+
+        for (size_t cnt = n_blocks; cnt > 1; cnt = (cnt + 1) / 2) {
+            auto const& below = levels.empty() ? leaves : levels.back();
+            std::vector<std::optional<qr_fact<T>>> lvl((cnt + 1) / 2);
+            par_for(cnt / 2, 1, [&](size_t p0, size_t p1) {
+                for (size_t p = p0; p < p1; p++) {
+                    owned_col_mat<T> stacked(2 * cols, cols);
+                    for (size_t j = 0; j < cols; j++) {
+                        memcpy(stacked.col_ptr(j),        top_r(below, 2 * p    ).col(j),
+                               (j + 1) * sizeof(T));
+                        memcpy(stacked.col_ptr(j) + cols, top_r(below, 2 * p + 1).col(j),
+                               (j + 1) * sizeof(T));
+                    }
+                    lvl[p].emplace(std::move(stacked), block);
+                }
+            });
+            levels.push_back(std::move(lvl));
+        }
+    }
+    /// --- end constructors ---
+
+    /// --- accessors ---
+    [[nodiscard]] size_t n_rows  () const noexcept { return rows; }
+    [[nodiscard]] size_t n_cols  () const noexcept { return cols; }
+    [[nodiscard]] size_t n_blocks() const noexcept { return leaves.size(); }
+
+    [[nodiscard]] owned_col_mat<T> r() const { return root().r(); }
+    /// --- end accessors ---
+
+    /// --- least squares ---
+    // Minimizes ||Ax - b||.
+    template<typename OT, bool ohs>
+    [[nodiscard]] owned_vec<T> solve(vec<OT, ohs> b) const {
+        if (b.len() != rows) throw vec_len_mismatch(rows, b.len());
+        std::vector<owned_vec<T>> tops(leaves.size());
+        par_for(leaves.size(), 1, [&](size_t b0, size_t b1) {
+            for (size_t l = b0; l < b1; l++) {
+                owned_vec<T> part(offs[l + 1] - offs[l], false);
+                for (size_t i = 0; i < part.len(); i++)
+                    part.ptr()[i] = b.ptr()[(offs[l] + i) * b.stride()];
+                leaves[l]->apply_qt(col_mat<T>(part.ptr(), part.len(), 1));
+                tops[l] = owned_vec<T>(vec<T, false>(part.ptr(), cols));
+            }
+        });
+        for (auto const& lvl : levels) {
+            std::vector<owned_vec<T>> next(lvl.size());
+            for (size_t p = 0; p < lvl.size(); p++) {
+                if (!lvl[p]) { next[p] = std::move(tops[2 * p]); continue; }
+                owned_vec<T> stacked(2 * cols, false);
+                memcpy(stacked.ptr(),        tops[2 * p    ].ptr(), cols * sizeof(T));
+                memcpy(stacked.ptr() + cols, tops[2 * p + 1].ptr(), cols * sizeof(T));
+                lvl[p]->apply_qt(col_mat<T>(stacked.ptr(), stacked.len(), 1));
+                next[p] = owned_vec<T>(vec<T, false>(stacked.ptr(), cols));
+            }
+            tops = std::move(next);
+        }
+        root().back_substitute(tops[0].ptr());
+        return std::move(tops[0]);
+    }
+    /// --- end least squares ---
+
+private:
+    // Node i of a tree level, or the nearest factored node below it when i passes through.
+    [[nodiscard]] qr_fact<T> const& top_r(std::vector<std::optional<qr_fact<T>>> const& lvl,
+                                          size_t i) const {
+        if (lvl[i]) return *lvl[i];
+        for (size_t l = levels.size(); l-- > 0;) {
+            if (&levels[l] != &lvl) continue;
+            return top_r(l == 0 ? leaves : levels[l - 1], 2 * i);
+        }
+        return *leaves[i];
+    }
+    [[nodiscard]] qr_fact<T> const& root() const
+        { return levels.empty() ? *leaves[0] : top_r(levels.back(), 0); }
+};
+
+// Least-squares solution of Ax = b; tall-skinny systems go through TSQR.
+template<typename T, typename OT, bool ohs>
+[[nodiscard]] owned_vec<std::remove_const_t<T>> lstsq(col_mat<T> a, vec<OT, ohs> b) {
+    using U = std::remove_const_t<T>;
+    if (par_threads() > 1 && a.n_rows() >= 4 * par_threads() * std::max<size_t>(a.n_cols(), 1))
+        return tsqr_fact<U>(a).solve(b);
+    return qr_fact<U>(a).solve(b);
+}
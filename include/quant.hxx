@@ -0,0 +1,268 @@
+#pragma once
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include "par.hxx"
+#include "prof.hxx"
+#include "tune.hxx"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Symmetric integer quantization of f32 matrices and products of quantized matrices.
+// A quantized matrix stores q(i, j) = round(a(i, j) / s) in i8 or i16, with one scale s per
+// row or per column, chosen so that the largest magnitude maps to the largest value of the
+// type. A product C = A B of an A scaled per row and a B scaled per column accumulates the
+// integer dot products exactly and applies both scales once per output element:
+//     c(i, j) = sa[i] sb[j] sum_k qa(i, k) qb(k, j)
+// so weights are typically A scaled per row (y = W x) or B scaled per column (y = x W), with
+// activations quantized the other way. Scales along k cannot be factored out of the sums
+// and are not supported. The kernels are widening dot products that the compiler vectorizes
+// to pmaddwd (or VNNI dot-product instructions where targeted); i8 products are summed in
+// i32 over blocks short enough not to overflow, and i16 products in i64.
+
+enum class quant_axis { row, col };
+
+template<typename Q> struct quant_traits;
+template<> struct quant_traits<i8> final {
+    using acc = i32;
+    static constexpr i8 max = 127;
+    // Products are at most 2^14 in magnitude, so 2^16 of them sum within i32.
+    static constexpr size_t chunk = size_t {1} << 16;
+};
+template<> struct quant_traits<i16> final {
+    using acc = i64; // two full-range products already overflow i32
+    static constexpr i16 max = 32767;
+    static constexpr size_t chunk = size_t {1} << 32;
+};
+
+template<typename Q>
+concept quant_int = std::is_same_v<Q, i8> || std::is_same_v<Q, i16>;
+
+// An element that is not finite once converted to f32 has no quantized value.
+struct quant_non_finite : std::domain_error {
+    quant_non_finite(size_t row, size_t col) : std::domain_error(mk_errmsg(row, col)) {}
+private:
+    static std::string mk_errmsg(size_t row, size_t col) {
+        std::stringstream s;
+        s << "cannot quantize non-finite element (" << row << ", " << col << ')';
+        return s.str();
+    }
+};
+
+// A quantized matrix, owning its values and the scales along ax.
+template<typename Q, mat_maj maj, quant_axis ax> requires quant_int<Q>
+struct quant_mat final {
+    owned_mat<Q, maj> q;
+    owned_vec<f32>    scale; // one per row (quant_axis::row) or column (quant_axis::col)
+};
+
+/// --- quantization ---
+// Throws quant_non_finite, naming the first such element in storage order, for a matrix
+// holding infinities, NaNs or values beyond the range of f32.
+template<typename Q, quant_axis ax, typename T, mat_maj maj>
+    requires quant_int<Q> && std::is_floating_point_v<std::remove_const_t<T>>
+[[nodiscard]] quant_mat<Q, maj, ax> quantize(mat<T, maj> a) {
+    constexpr f32 qmax = quant_traits<Q>::max;
+    size_t ns = ax == quant_axis::row ? a.n_rows() : a.n_cols();
+    quant_mat<Q, maj, ax> r {owned_mat<Q, maj>(a.n_rows(), a.n_cols(), false),
+                             owned_vec<f32>(ns)};
+    f32* s = r.scale.ptr();
+    // Scales are kept along one axis and majvecs run along either, so the loops over the
+    // elements of a majvec either reduce into one scale or update one scale per element.
+    constexpr bool along = (ax == quant_axis::row) == (maj == mat_maj::row);
+    // Magnitudes failing v <= fmax (infinities and NaNs) are flagged on the way.
+    constexpr f32 fmax = std::numeric_limits<f32>::max();
+    size_t m = a.n_maj(), n = a.n_min();
+    unsigned bad = 0;
+    for (size_t i = 0; i < m; i++) {
+        T const* p = a.base_ptr() + (i * n);
+        if constexpr (along) {
+            f32 big = 0;
+            for (size_t k = 0; k < n; k++) {
+                f32 v = std::abs(f32(p[k]));
+                big = std::max(big, v);
+                bad |= unsigned(!(v <= fmax));
+            }
+            s[i] = big;
+        } else {
+            for (size_t k = 0; k < n; k++) {
+                f32 v = std::abs(f32(p[k]));
+                s[k] = std::max(s[k], v);
+                bad |= unsigned(!(v <= fmax));
+            }
+        }
+    }
+    for (size_t i = 0; bad && i < m; i++) {
+        T const* p = a.base_ptr() + (i * n);
+        for (size_t k = 0; k < n; k++) {
+            if (std::abs(f32(p[k])) <= fmax) continue;
+            if constexpr (maj == mat_maj::row) throw quant_non_finite(i, k);
+            else                               throw quant_non_finite(k, i);
+        }
+    }
+    owned_vec<f32> inv(ns, false);
+    for (size_t i = 0; i < ns; i++) {
+        s[i] /= qmax;
+        inv.ptr()[i] = s[i] > 0 ? 1 / s[i] : 0;
+    }
+    f32 const* iv = inv.ptr();
+    for (size_t i = 0; i < m; i++) {
+        T const* p = a.base_ptr() + (i * n);
+        Q*       q = r.q.base_ptr() + (i * n);
+        for (size_t k = 0; k < n; k++) {
+            f32 v = std::nearbyint(f32(p[k]) * (along ? iv[i] : iv[k]));
+            q[k] = Q(std::clamp(v, -qmax, qmax));
+        }
+    }
+    return r;
+}
+
+// a(i, j) := q(i, j) * scale[i or j], into a new f32 matrix of the same storage order.
+template<typename Q, mat_maj maj, quant_axis ax>
+[[nodiscard]] owned_mat<f32, maj> dequantize(quant_mat<Q, maj, ax> const& a) {
+    owned_mat<f32, maj> r(a.q.n_rows(), a.q.n_cols(), false);
+    constexpr bool along = (ax == quant_axis::row) == (maj == mat_maj::row);
+    f32 const* s = a.scale.ptr();
+    size_t m = a.q.n_maj(), n = a.q.n_min();
+    for (size_t i = 0; i < m; i++) {
+        Q const* q = a.q.base_ptr() + (i * n);
+        f32*     p = r.base_ptr() + (i * n);
+        for (size_t k = 0; k < n; k++) p[k] = f32(q[k]) * (along ? s[i] : s[k]);
+    }
+    return r;
+}
+/// --- end quantization ---
+
+struct qgemm_kernel final {
+    // Bytes of b per block of output columns, kept in L2 while every row of a passes by.
+    static constexpr size_t block_bytes = size_t {1} << 17;
+
+    // out[l] := sum_k a[k] b_l[k] for the four rows b_l at distance ldb from b.
+    template<typename Q>
+    static void dot4(size_t k, Q const* a, Q const* b, size_t ldb, i64* out) noexcept {
+        using A = typename quant_traits<Q>::acc;
+        Q const* b0 = b;
+        Q const* b1 = b0 + ldb, *b2 = b1 + ldb, *b3 = b2 + ldb;
+        i64 t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+        for (size_t c0 = 0; c0 < k; c0 += quant_traits<Q>::chunk) {
+            size_t c1 = std::min(k, c0 + quant_traits<Q>::chunk);
+            A s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            for (size_t c = c0; c < c1; c++) {
+                A x = a[c];
+                s0 += x * A(b0[c]);
+                s1 += x * A(b1[c]);
+                s2 += x * A(b2[c]);
+                s3 += x * A(b3[c]);
+            }
+            t0 += s0; t1 += s1; t2 += s2; t3 += s3;
+        }
+        out[0] = t0; out[1] = t1; out[2] = t2; out[3] = t3;
+    }
+    template<typename Q>
+    [[nodiscard]] static i64 dot(size_t k, Q const* a, Q const* b) noexcept {
+        using A = typename quant_traits<Q>::acc;
+        i64 t = 0;
+        for (size_t c0 = 0; c0 < k; c0 += quant_traits<Q>::chunk) {
+            size_t c1 = std::min(k, c0 + quant_traits<Q>::chunk);
+            A s = 0;
+            for (size_t c = c0; c < c1; c++) s += A(a[c]) * A(b[c]);
+            t += s;
+        }
+        return t;
+    }
+
+    // Copies column-major v into row-major out, in tiles that stay in L1.
+    template<typename Q>
+    static void pack(mat<Q const, mat_maj::col> v, Q* out) noexcept {
+        size_t m = v.n_rows(), n = v.n_cols();
+        constexpr size_t tile = 64;
+        for (size_t i0 = 0; i0 < m; i0 += tile) for (size_t j0 = 0; j0 < n; j0 += tile) {
+            size_t i1 = std::min(m, i0 + tile), j1 = std::min(n, j0 + tile);
+            for (size_t i = i0; i < i1; i++)
+                for (size_t j = j0; j < j1; j++) out[(i * n) + j] = v.base_ptr()[(j * m) + i];
+        }
+    }
+
+    // c(i, j) := sa[i] sb[j] (row i of a) . (row j of bt), for a m x k and bt n x k.
+    template<typename Q, typename CT, mat_maj cm>
+    static void run(mat<Q const, mat_maj::row> a, f32 const* sa, mat<Q const, mat_maj::row> bt,
+                    f32 const* sb, mat<CT, cm> c) {
+        size_t m = a.n_rows(), k = a.n_cols(), n = bt.n_rows();
+        size_t jb = std::max<size_t>(4, (block_bytes / ((k * sizeof(Q)) + 1)) & ~size_t {3});
+        auto put = [&](size_t i, size_t j, i64 v)
+            { c.base_ptr()[c.row_idx(i) + c.col_idx(j)] = sa[i] * sb[j] * f32(v); };
+        par_for(m, std::max<size_t>(1, tuned().dense_grain / ((k * n) + 1)),
+                [&](size_t i0, size_t i1) {
+            for (size_t j0 = 0; j0 < n; j0 += jb) {
+                size_t j1 = std::min(n, j0 + jb);
+                for (size_t i = i0; i < i1; i++) {
+                    Q const* ai = a.row_ptr(i);
+                    size_t j = j0;
+                    for (; j + 4 <= j1; j += 4) {
+                        i64 v[4];
+                        dot4(k, ai, bt.row_ptr(j), k, v);
+                        for (size_t l = 0; l < 4; l++) put(i, j + l, v[l]);
+                    }
+                    for (; j < j1; j++) put(i, j, dot(k, ai, bt.row_ptr(j)));
+                }
+            }
+        });
+    }
+};
+
+/// --- products with size unsafety ---
+// c(i, j) := sa[i] sb[j] sum_k a(i, k) b(k, j), for views of quantized values and their
+// scales. The kernel wants a row-major and b column-major, so that both run along k;
+// operands stored the other way are repacked first.
+template<typename AT, mat_maj am, typename SAT, bool sahs, typename BT, mat_maj bm, typename SBT,
+         bool sbhs, typename CT, mat_maj cm>
+    requires quant_int<std::remove_const_t<AT>> && std::is_same_v<std::remove_const_t<AT>,
+                                                                  std::remove_const_t<BT>>
+             && (!std::is_const_v<CT>)
+void qgemm_nocklen(mat<AT, am> a, vec<SAT, sahs> sa, mat<BT, bm> b, vec<SBT, sbhs> sb,
+                   mat<CT, cm> c) {
+    using Q = std::remove_const_t<AT>;
+    size_t m = a.n_rows(), k = a.n_cols(), n = b.n_cols();
+    MATRIX_PROF_SCOPE("qgemm", m, n, ((m * k) + (k * n)) * sizeof(Q) + (m * n * sizeof(CT)),
+                      2 * m * k * n);
+    // Operands already in the kernel's order leave their buffers empty.
+    constexpr bool apk = am == mat_maj::col, bpk = bm == mat_maj::row;
+    owned_mat<Q, mat_maj::row> apack(apk ? m : 0, apk ? k : 0, false);
+    owned_mat<Q, mat_maj::row> bpack(bpk ? n : 0, bpk ? k : 0, false);
+    mat<Q const, mat_maj::row> ar, btr;
+    if constexpr (apk) qgemm_kernel::pack(a.as_const(), apack.base_ptr());
+    if constexpr (bpk) qgemm_kernel::pack(b.as_const().transposed(), bpack.base_ptr());
+    if constexpr (apk) ar = apack.as_const(); else ar = a.as_const();
+    if constexpr (bpk) btr = bpack.as_const(); else btr = b.as_const().transposed();
+    owned_vec<f32> sap(m, false), sbp(n, false);
+    for (size_t i = 0; i < m; i++) sap.ptr()[i] = f32(sa.ptr()[i * sa.stride()]);
+    for (size_t j = 0; j < n; j++) sbp.ptr()[j] = f32(sb.ptr()[j * sb.stride()]);
+    qgemm_kernel::run(ar, sap.ptr(), btr, sbp.ptr(), c);
+}
+/// --- end products with size unsafety ---
+
+/// --- products ---
+template<typename AT, mat_maj am, typename SAT, bool sahs, typename BT, mat_maj bm, typename SBT,
+         bool sbhs, typename CT, mat_maj cm>
+    requires quant_int<std::remove_const_t<AT>> && std::is_same_v<std::remove_const_t<AT>,
+                                                                  std::remove_const_t<BT>>
+             && (!std::is_const_v<CT>)
+void qgemm(mat<AT, am> a, vec<SAT, sahs> sa, mat<BT, bm> b, vec<SBT, sbhs> sb, mat<CT, cm> c) {
+    if (a.n_cols() != b.n_rows())
+        throw mat_size_mismatch(a.n_rows(), a.n_cols(), b.n_rows(), b.n_cols());
+    if (a.n_rows() != c.n_rows() || b.n_cols() != c.n_cols())
+        throw mat_size_mismatch(a.n_rows(), b.n_cols(), c.n_rows(), c.n_cols());
+    if (sa.len() != a.n_rows()) throw vec_len_mismatch(a.n_rows(), sa.len());
+    if (sb.len() != b.n_cols()) throw vec_len_mismatch(b.n_cols(), sb.len());
+    qgemm_nocklen(a, sa, b, sb, c);
+}
+
+// A B into a new row-major f32 matrix.
+template<typename Q, mat_maj am, mat_maj bm>
+[[nodiscard]] owned_mat<f32, mat_maj::row> qgemm(quant_mat<Q, am, quant_axis::row> const& a,
+                                                 quant_mat<Q, bm, quant_axis::col> const& b) {
+    owned_mat<f32, mat_maj::row> c(a.q.n_rows(), b.q.n_cols(), false);
+    qgemm(a.q.as_const(), a.scale.as_const(), b.q.as_const(), b.scale.as_const(), c.as_ref());
+    return c;
+}
+/// --- end products ---
@@ -0,0 +1,95 @@
+#pragma once
+#include "par.hxx"
+#include "perf.hxx"
+#include "simd.hxx"
+#include <chrono>
+#include <iomanip>
+#include <memory>
+
+// Roofline model of the machine and of the instrumented call sites. Attainable throughput
+// at arithmetic intensity I (flops per byte) is min(peak flops, I * memory bandwidth); the
+// probes below measure both roofs, and the report places every site recorded by
+// perf_registry (MATRIX_PERF_COUNTERS builds) under them.
+
+struct roofline_machine final {
+    double gbps   {}; // memory bandwidth, GB/s
+    double gflops {}; // peak double-precision throughput, GFLOP/s
+
+    // Intensity at which the two roofs meet.
+    [[nodiscard]] double ridge() const noexcept { return gbps ? gflops / gbps : 0; }
+    [[nodiscard]] double attainable(double intensity) const noexcept
+        { return std::min(gflops, intensity * gbps); }
+};
+
+/// --- probes ---
+// STREAM triad a = b + s c over three arrays of n doubles, on all par_threads() threads.
+// Returns the best of reps runs in GB/s; n should make the arrays well exceed the last cache.
+[[nodiscard]] inline double stream_triad_gbps(size_t n = size_t {1} << 23, size_t reps = 5) {
+    auto a = std::make_unique<double[]>(n), b = std::make_unique<double[]>(n);
+    auto c = std::make_unique<double[]>(n);
+    size_t const grain = 1 << 16;
+    par_for(n, grain, [&](size_t i0, size_t i1) { // first touch by the threads that use them
+        for (size_t i = i0; i < i1; i++) { a[i] = 0; b[i] = 1; c[i] = 2; }
+    });
+    double best = 0;
+    for (size_t r = 0; r < reps; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        par_for(n, grain, [&](size_t i0, size_t i1) {
+            double* ap = a.get(); double const* bp = b.get(); double const* cp = c.get();
+            for (size_t i = i0; i < i1; i++) ap[i] = bp[i] + (3.0 * cp[i]);
+        });
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0);
+        best = std::max(best, double(3 * n * sizeof(double)) / ns.count());
+    }
+    return best;
+}
+
+// Independent multiply-add chains, wide enough to fill the vector units and hide their
+// latency, on all par_threads() threads. Returns GFLOP/s.
+[[nodiscard]] inline double peak_gflops(size_t iters = size_t {1} << 22) {
+    constexpr size_t chains = 8 * simd_lanes<double>;
+    std::vector<double> sink(par_threads());
+    auto t0 = std::chrono::steady_clock::now();
+    par_invoke(par_threads(), [&](size_t p) {
+        double acc[chains], mul = 0.999999, add = 1e-7;
+        for (size_t l = 0; l < chains; l++) acc[l] = double(l + p);
+        for (size_t i = 0; i < iters; i++) {
+            for (size_t l = 0; l < chains; l++) acc[l] = (acc[l] * mul) + add;
+        }
+        double s = 0;
+        for (double x : acc) s += x;
+        sink[p] = s;
+    });
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0);
+    return double(2 * chains * iters * par_threads()) / ns.count();
+}
+
+[[nodiscard]] inline roofline_machine roofline_probe()
+    { return {.gbps = stream_triad_gbps(), .gflops = peak_gflops()}; }
+/// --- end probes ---
+
+/// --- report ---
+// One line per recorded site: intensity, achieved throughput, the roof above it and
+// whether it sits left (memory-bound) or right (compute-bound) of the ridge.
+inline void roofline_report(std::ostream& o, roofline_machine m,
+                            std::map<std::string, perf_stats> const& sites) {
+    auto flags = o.flags();
+    auto prec  = o.precision();
+    o << std::fixed << std::setprecision(2)
+      << "bandwidth " << m.gbps << " GB/s, peak " << m.gflops << " GFLOP/s, ridge "
+      << m.ridge() << " flop/byte\n"
+      << std::left << std::setw(16) << "site" << std::right << std::setw(10) << "calls"
+      << std::setw(12) << "flop/byte" << std::setw(10) << "GB/s" << std::setw(10) << "GFLOP/s"
+      << std::setw(10) << "roof" << std::setw(8) << "%roof" << "  bound\n";
+    for (auto const& [site, s] : sites) {
+        double in = s.intensity(), roof = m.attainable(in);
+        double pct = roof > 0 ? 100 * s.gflops() / roof : 0;
+        char const* bound = s.flops == 0 ? "-" : in < m.ridge() ? "memory" : "compute";
+        o << std::left << std::setw(16) << site << std::right << std::setw(10) << s.calls
+          << std::setw(12) << in << std::setw(10) << s.gbps() << std::setw(10) << s.gflops()
+          << std::setw(10) << roof << std::setw(8) << pct << "  " << bound << '\n';
+    }
+    o.flags(flags);
+    o.precision(prec);
+}
+/// --- end report ---
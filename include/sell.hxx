@@ -0,0 +1,130 @@
+#pragma once
+#include "simd.hxx"
+#include "sparse.hxx"
+#include <numeric>
+
+// Sliced ELLPACK (SELL-C-sigma) sparse matrix for SpMV.
+// Rows are sorted by length inside windows of sigma rows, then grouped in chunks of C rows;
+// every chunk is padded to its longest row and stored column-major, so the kernel
+// processes C rows at once with one vector lane per row. Lanes past the length of their row
+// are masked out, so padding never multiplies x[0] (a NaN or Inf there stays out of y).
+template<typename T, size_t C = simd_lanes<T>> requires (!std::is_const_v<T> && C > 0)
+struct sell_mat final {
+protected:
+    /// --- fields ---
+    size_t              rows  {};
+    size_t              cols  {};
+    size_t              sigma {};
+    size_t              n_nz  {};
+    std::vector<size_t> cptr;  // first stored element of every chunk, plus the total
+    std::vector<size_t> perm;  // original row of every chunk lane
+    std::vector<size_t> len;   // stored elements of the row of every chunk lane
+    std::vector<size_t> idx;   // column of every stored element, 0 in padding
+    std::vector<T>      val;   // value of every stored element, 0 in padding
+    /// --- end fields ---
+
+    [[nodiscard]] static size_t par_grain() { return tuned().sparse_grain; }
+
+public:
+    static constexpr size_t chunk_height = C;
+
+    /// --- constructors ---
+    sell_mat() : cptr(1) {}
+
+    explicit sell_mat(csr_mat<T> const& a, size_t sigma = 32 * C)
+        : rows(a.n_rows()), cols(a.n_cols()), sigma(std::max<size_t>(sigma, 1)), n_nz(a.nnz()) {
+        auto ptr = a.offsets();
+        auto row_len = [&](size_t r) { return r < rows ? ptr[r + 1] - ptr[r] : 0; };
+
+        size_t n_chunks = (rows + C - 1) / C;
+        perm.resize(n_chunks * C);
+        std::iota(perm.begin(), perm.end(), 0);
+        for (size_t w = 0; w < rows; w += this->sigma) {
+            auto first = perm.begin() + w, last = perm.begin() + std::min(rows, w + this->sigma);
+            std::stable_sort(first, last,
+                             [&](size_t x, size_t y) { return row_len(x) > row_len(y); });
+        }
+
+        len.resize(n_chunks * C);
+        for (size_t l = 0; l < len.size(); l++) len[l] = row_len(perm[l]);
+        cptr.resize(n_chunks + 1);
+        for (size_t c = 0; c < n_chunks; c++) {
+            size_t width = 0;
+            for (size_t l = 0; l < C; l++) width = std::max(width, len[(c * C) + l]);
+            cptr[c + 1] = cptr[c] + (width * C);
+        }
+        idx.resize(cptr.back());
+        val.resize(cptr.back());
+        par_for(n_chunks, 64, [&](size_t c0, size_t c1) {
+            for (size_t c = c0; c < c1; c++) {
+                for (size_t l = 0; l < C; l++) {
+                    size_t r = perm[(c * C) + l];
+                    for (size_t j = 0; j < row_len(r); j++) {
+                        idx[cptr[c] + (j * C) + l] = a.indices()[ptr[r] + j];
+                        val[cptr[c] + (j * C) + l] = a.values ()[ptr[r] + j];
+                    }
+                }
+            }
+        });
+    }
+
+    [[nodiscard]] static sell_mat from_entries(size_t rows, size_t cols,
+                                               std::vector<coo_entry<T>> const& es,
+                                               size_t sigma = 32 * C)
+        { return sell_mat(csr_mat<T>::from_entries(rows, cols, es), sigma); }
+    /// --- end constructors ---
+
+    /// --- accessors ---
+    [[nodiscard]] size_t n_rows  () const noexcept { return rows; }
+    [[nodiscard]] size_t n_cols  () const noexcept { return cols; }
+    [[nodiscard]] size_t nnz     () const noexcept { return n_nz; }
+    [[nodiscard]] size_t n_stored() const noexcept { return val.size(); }
+    [[nodiscard]] size_t n_chunks() const noexcept { return cptr.size() - 1; }
+    [[nodiscard]] size_t window  () const noexcept { return sigma; }
+    /// --- end accessors ---
+
+    /// --- products ---
+    // y := A x
+    template<typename OT, bool xhs>
+    void mul_vec_nocklen(vec<OT, xhs> x, vec<T, false> y) const {
+        MATRIX_PROF_SCOPE("sell.spmv", rows, cols, (n_stored() * (sizeof(T) + sizeof(size_t)))
+                                                 + ((rows + cols) * sizeof(T)), 2 * nnz());
+        OT const* xp = x.ptr();
+        T*        yp = y.ptr();
+        size_t    xs = x.stride();
+        par_for_balanced(n_chunks(), cptr.data(), par_grain(), [&](size_t c0, size_t c1) {
+            for (size_t c = c0; c < c1; c++) {
+                T acc[C] {};
+                size_t const* ci = idx.data() + cptr[c];
+                T const*      cv = val.data() + cptr[c];
+                size_t const* cl = len.data() + (c * C);
+                // Steps where every lane holds an element, then the padded tail lane by lane.
+                size_t k = 0, n = cptr[c + 1] - cptr[c], full = *std::min_element(cl, cl + C);
+                for (; k < full * C; k += C) {
+                    for (size_t l = 0; l < C; l++) acc[l] += cv[k + l] * xp[ci[k + l] * xs];
+                }
+                for (size_t j = full; k < n; k += C, j++) {
+                    for (size_t l = 0; l < C; l++)
+                        if (j < cl[l]) acc[l] += cv[k + l] * xp[ci[k + l] * xs];
+                }
+                for (size_t l = 0; l < C; l++) {
+                    size_t r = perm[(c * C) + l];
+                    if (r < rows) yp[r] = acc[l];
+                }
+            }
+        });
+    }
+    template<typename OT, bool xhs>
+    void mul_vec(vec<OT, xhs> x, vec<T, false> y) const {
+        if (x.len() != cols) throw vec_len_mismatch(cols, x.len());
+        if (y.len() != rows) throw vec_len_mismatch(rows, y.len());
+        mul_vec_nocklen(x, y);
+    }
+    template<typename OT, bool xhs>
+    [[nodiscard]] owned_vec<T> operator *(vec<OT, xhs> x) const {
+        owned_vec<T> y(rows, false);
+        mul_vec(x, y.as_ref());
+        return y;
+    }
+    /// --- end products ---
+};
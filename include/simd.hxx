@@ -0,0 +1,102 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+/// --- SIMD width ---
+// Width in bytes of the widest vector registers the build targets.
+#if defined(__AVX512F__)
+inline constexpr size_t simd_bytes = 64;
+#elif defined(__AVX__)
+inline constexpr size_t simd_bytes = 32;
+#else
+inline constexpr size_t simd_bytes = 16;
+#endif
+template<typename T>
+inline constexpr size_t simd_lanes = std::max<size_t>(1, simd_bytes / sizeof(T));
+/// --- end SIMD width ---
+
+/// --- lane reductions ---
+// Sums f(i) over [0, n) into L independent accumulators that are added up at the end.
+// Without -ffast-math compilers may not reorder a single floating-point accumulator,
+// so this is what lets reductions vectorize (contiguous data) or overlap latencies (strided).
+template<typename T, size_t L = 2 * simd_lanes<T>, typename F>
+[[nodiscard]] T lane_sum(size_t n, F&& f) {
+    static_assert(std::has_single_bit(L));
+    T acc[L] {};
+    size_t i = 0;
+    for (; i + L <= n; i += L) for (size_t l = 0; l < L; l++) acc[l] += f(i + l);
+    for (; i < n; i++) acc[0] += f(i);
+    for (size_t w = L / 2; w > 0; w /= 2) for (size_t l = 0; l < w; l++) acc[l] += acc[l + w];
+    return acc[0];
+}
+
+/// --- compensated and pairwise sums ---
+// How sums of many terms are accumulated: fast lane sums (lane_sum), pairwise summation
+// with error growing as log n rather than n, or Kahan-Babuska (Neumaier) compensation
+// with error independent of n. Both keep the L lanes, so they still vectorize.
+enum class sum_mode { fast, pairwise, kahan };
+
+// Adds x to the compensated sum (s, c); c collects the low-order bits lost from s.
+// The error of s + x is found with Knuth's branch-free two-sum, so lanes vectorize.
+template<typename T>
+void kb_add(T& s, T& c, T x) noexcept {
+    T t = s + x;
+    T z = t - s;
+    c += (s - (t - z)) + (x - z);
+    s = t;
+}
+
+template<typename T, size_t L = 2 * simd_lanes<T>, typename F>
+[[nodiscard]] T lane_sum_kahan(size_t n, F&& f) {
+    static_assert(std::has_single_bit(L));
+    T s[L] {}, c[L] {};
+    size_t i = 0;
+    for (; i + L <= n; i += L) for (size_t l = 0; l < L; l++) kb_add(s[l], c[l], T(f(i + l)));
+    for (; i < n; i++) kb_add(s[0], c[0], T(f(i)));
+    T sum {}, comp {};
+    for (size_t l = 0; l < L; l++) { kb_add(sum, comp, s[l]); comp += c[l]; }
+    return sum + comp;
+}
+
+// Sums f(i0 + i) over [0, n) as two halves, down to leaves of lane_sum.
+template<typename T, size_t L, typename F>
+[[nodiscard]] T lane_sum_pairwise_at(size_t i0, size_t n, F& f) {
+    constexpr size_t leaf = 32 * L;
+    if (n <= leaf) return lane_sum<T, L>(n, [&](size_t i) { return f(i0 + i); });
+    size_t h = n / 2 / L * L;
+    return lane_sum_pairwise_at<T, L>(i0, h, f) + lane_sum_pairwise_at<T, L>(i0 + h, n - h, f);
+}
+template<typename T, size_t L = 2 * simd_lanes<T>, typename F>
+[[nodiscard]] T lane_sum_pairwise(size_t n, F&& f) { return lane_sum_pairwise_at<T, L>(0, n, f); }
+
+template<typename T, size_t L = 2 * simd_lanes<T>, typename F>
+[[nodiscard]] T lane_sum(sum_mode m, size_t n, F&& f) {
+    switch (m) {
+    case sum_mode::pairwise: return lane_sum_pairwise<T, L>(n, f);
+    case sum_mode::kahan:    return lane_sum_kahan<T, L>(n, f);
+    default:                 return lane_sum<T, L>(n, f);
+    }
+}
+/// --- end compensated and pairwise sums ---
+
+// Folds f(i) over [0, n), n > 0, with op into L accumulators seeded with the first L values
+// and combined pairwise at the end. op must be associative and commutative.
+template<typename T, size_t L = 2 * simd_lanes<T>, typename Op, typename F>
+[[nodiscard]] T lane_fold(size_t n, Op&& op, F&& f) {
+    static_assert(std::has_single_bit(L));
+    if (n < L) {
+        T a = f(0);
+        for (size_t i = 1; i < n; i++) a = op(a, f(i));
+        return a;
+    }
+    T acc[L];
+    for (size_t l = 0; l < L; l++) acc[l] = f(l);
+    size_t i = L;
+    for (; i + L <= n; i += L) for (size_t l = 0; l < L; l++) acc[l] = op(acc[l], f(i + l));
+    for (; i < n; i++) acc[0] = op(acc[0], f(i));
+    for (size_t w = L / 2; w > 0; w /= 2)
+        for (size_t l = 0; l < w; l++) acc[l] = op(acc[l], acc[l + w]);
+    return acc[0];
+}
+/// --- end lane reductions ---
@@ -0,0 +1,371 @@
+#pragma once
+#include "blas1.hxx"
+#include "gemv.hxx"
+#include "sell.hxx"
+#include "sparse.hxx"
+#include <cmath>
+#include <concepts>
+
+struct zero_pivot : std::runtime_error {
+    zero_pivot(size_t row) : std::runtime_error(mk_errmsg(row)) {}
+private:
+    static std::string mk_errmsg(size_t row) {
+        std::stringstream s;
+        s << "zero pivot in row " << row;
+        return s.str();
+    }
+};
+
+/// --- linear operators ---
+// y := A x for the operator kinds the iterative solvers accept.
+template<typename U, mat_maj maj, typename T>
+void op_apply(mat<U, maj> const& a, vec<T const, false> x, vec<T, false> y)
+    { gemv_nocklen(T {1}, a, x, T {}, y); }
+template<typename T, mat_maj maj>
+void op_apply(sparse_mat<T, maj> const& a, vec<T const, false> x, vec<T, false> y)
+    { a.mul_vec_nocklen(x, y); }
+template<typename T, size_t C>
+void op_apply(sell_mat<T, C> const& a, vec<T const, false> x, vec<T, false> y)
+    { a.mul_vec_nocklen(x, y); }
+template<typename F, typename T>
+    requires std::invocable<F const&, vec<T const, false>, vec<T, false>>
+void op_apply(F const& f, vec<T const, false> x, vec<T, false> y) { f(x, y); }
+
+template<typename Op, typename T>
+concept linear_op = requires(Op const& a, vec<T const, false> x, vec<T, false> y)
+    { op_apply(a, x, y); };
+
+// Bytes moved and flops of one op_apply, for profiling; zero for functions.
+struct op_work final { uint64_t bytes, flops; };
+template<typename T, typename Op>
+[[nodiscard]] op_work op_cost(Op const& a) noexcept {
+    if constexpr (requires { a.nnz(); }) {
+        return {(a.nnz() * (sizeof(T) + sizeof(size_t)))
+                    + ((a.n_rows() + a.n_cols()) * sizeof(T)),
+                2 * a.nnz()};
+    } else if constexpr (requires { a.n_rows(); a.n_cols(); }) {
+        return {((a.n_rows() * a.n_cols()) + a.n_rows() + a.n_cols()) * sizeof(T),
+                2 * a.n_rows() * a.n_cols()};
+    } else {
+        return {0, 0};
+    }
+}
+/// --- end linear operators ---
+
+/// --- preconditioners ---
+// z := M^-1 r
+struct no_precond final {
+    template<typename T>
+    void apply(vec<T const, false> r, vec<T, false> z) const noexcept
+        { if (z.ptr() != r.ptr()) memcpy(z.ptr(), r.ptr(), r.len() * sizeof(T)); }
+};
+
+template<typename T>
+struct jacobi_precond final {
+protected:
+    owned_vec<T> inv_diag;
+
+public:
+    template<typename U, mat_maj maj>
+    explicit jacobi_precond(mat<U, maj> const& a) : inv_diag(std::min(a.n_rows(), a.n_cols())) {
+        for (size_t i = 0; i < inv_diag.len(); i++) set(i, a.row_ptr(i)[a.col_idx(i)]);
+    }
+    template<mat_maj maj>
+    explicit jacobi_precond(sparse_mat<T, maj> const& a)
+        : inv_diag(std::min(a.n_rows(), a.n_cols())) {
+        for (size_t i = 0; i < inv_diag.len(); i++) set(i, a.at(i, i));
+    }
+
+    void apply(vec<T const, false> r, vec<T, false> z) const noexcept {
+        T const* d = inv_diag.ptr();
+        for (size_t i = 0; i < r.len(); i++) z.ptr()[i] = d[i] * r.ptr()[i];
+    }
+
+private:
+    void set(size_t i, T d) {
+        if (d == T {}) throw zero_pivot(i);
+        inv_diag.ptr()[i] = T {1} / d;
+    }
+};
+
+// Incomplete LU factorization with the sparsity pattern of A.
+template<typename T>
+struct ilu0_precond final {
+protected:
+    csr_mat<T>          lu;   // unit lower triangle of L below the diagonal, U on and above it
+    std::vector<size_t> diag; // position of the diagonal element of every row
+
+public:
+    explicit ilu0_precond(csr_mat<T> lu) : lu(std::move(lu)), diag(this->lu.n_rows()) {
+        size_t n = this->lu.n_rows();
+        if (this->lu.n_cols() != n) throw mat_size_mismatch(n, this->lu.n_cols(), n, n);
+        auto ptr = this->lu.offsets();
+        auto idx = this->lu.indices();
+        auto val = this->lu.values();
+        std::vector<size_t> pos(n, SIZE_MAX);
+        for (size_t i = 0; i < n; i++) {
+            auto first = idx.begin() + ptr[i], last = idx.begin() + ptr[i + 1];
+            auto d = std::lower_bound(first, last, i);
+            if (d == last || *d != i) throw zero_pivot(i);
+            diag[i] = d - idx.begin();
+
+            for (size_t p = ptr[i]; p < ptr[i + 1]; p++) pos[idx[p]] = p;
+            for (size_t p = ptr[i]; p < diag[i]; p++) {
+                size_t k = idx[p];
+                val[p] /= val[diag[k]];
+                for (size_t q = diag[k] + 1; q < ptr[k + 1]; q++)
+                    if (pos[idx[q]] != SIZE_MAX) val[pos[idx[q]]] -= val[p] * val[q];
+            }
+            for (size_t p = ptr[i]; p < ptr[i + 1]; p++) pos[idx[p]] = SIZE_MAX;
+            if (val[diag[i]] == T {}) throw zero_pivot(i);
+        }
+    }
+
+    void apply(vec<T const, false> r, vec<T, false> z) const noexcept {
+        auto ptr = lu.offsets();
+        auto idx = lu.indices();
+        auto val = lu.values();
+        T*   zp  = z.ptr();
+        for (size_t i = 0; i < lu.n_rows(); i++) {
+            T s = r.ptr()[i];
+            for (size_t p = ptr[i]; p < diag[i]; p++) s -= val[p] * zp[idx[p]];
+            zp[i] = s;
+        }
+        for (size_t i = lu.n_rows(); i-- > 0;) {
+            T s = zp[i];
+            for (size_t p = diag[i] + 1; p < ptr[i + 1]; p++) s -= val[p] * zp[idx[p]];
+            zp[i] = s / val[diag[i]];
+        }
+    }
+};
+
+template<typename Pc, typename T>
+concept preconditioner = requires(Pc const& m, vec<T const, false> r, vec<T, false> z)
+    { m.apply(r, z); };
+/// --- end preconditioners ---
+
+/// --- solvers ---
+struct solve_opts final {
+    double tol      = 1e-8; // relative to ||b||
+    size_t max_iter = 1000;
+    size_t restart  = 30;   // Krylov dimension of GMRES(m)
+    sum_mode sum    = sum_mode::fast; // accumulation of inner products and norms
+};
+struct solve_result final {
+    size_t iters;
+    double resid;           // final ||b - Ax|| / ||b|| as tracked by the solver
+    bool   converged;
+};
+
+// Krylov solvers for Ax = b that keep their work vectors between calls,
+// so repeated solves of the same size allocate nothing.
+// x holds the initial guess on entry and the solution on return.
+template<typename T>
+struct krylov_solver final {
+    static_assert(std::is_floating_point_v<T>);
+
+protected:
+    solve_opts       opts;
+    owned_col_mat<T> work;
+    owned_col_mat<T> hess; // GMRES Hessenberg matrix plus Givens rotations and rhs
+
+public:
+    explicit krylov_solver(solve_opts opts = {}) : opts(opts), work(0, 0), hess(0, 0) {}
+
+    [[nodiscard]] solve_opts const& options() const noexcept { return opts; }
+
+    /// --- conjugate gradient ---
+    // A and M must be symmetric positive definite.
+    template<linear_op<T> Op, preconditioner<T> Pc = no_precond>
+    solve_result cg(Op const& a, vec<T const, false> b, vec<T, false> x, Pc const& m = {}) {
+        size_t n = prepare(a, b, x, 4);
+        MATRIX_PROF_SCOPE_AS(prof, "cg", n, n, 0, 0);
+        // One product and 5 vector kernels over 13 vectors per iteration.
+        auto done = [&](solve_result r) {
+            MATRIX_PROF_ADD(prof, r.iters * (op_cost<T>(a).bytes + (13 * n * sizeof(T))),
+                            r.iters * (op_cost<T>(a).flops + (13 * n)));
+            return r;
+        };
+        auto r = wv(0, n), z = wv(1, n), p = wv(2, n), ap = wv(3, n);
+        T bnorm = norm_or_one(b);
+
+        op_apply(a, x.as_const(), ap);
+        T rr = sub_dot(b, ap, r);
+        if (std::sqrt(rr) <= opts.tol * bnorm) return done({0, std::sqrt(rr) / bnorm, true});
+        m.apply(r.as_const(), z);
+        T rz = dot_nocklen(r, z, opts.sum);
+        memcpy(p.ptr(), z.ptr(), n * sizeof(T));
+        for (size_t it = 1; it <= opts.max_iter; it++) {
+            op_apply(a, p.as_const(), ap);
+            T alpha = rz / dot_nocklen(p, ap, opts.sum);
+            axpy_nocklen(alpha, p, x);
+            rr = axpy_dot_nocklen(-alpha, ap, r, r, opts.sum);
+            if (std::sqrt(rr) <= opts.tol * bnorm) return done({it, std::sqrt(rr) / bnorm, true});
+            m.apply(r.as_const(), z);
+            T rz_next = dot_nocklen(r, z, opts.sum);
+            axpby_nocklen(T {1}, z, rz_next / rz, p);
+            rz = rz_next;
+        }
+        return done({opts.max_iter, std::sqrt(rr) / bnorm, false});
+    }
+    /// --- end conjugate gradient ---
+
+    /// --- stabilized biconjugate gradient ---
+    template<linear_op<T> Op, preconditioner<T> Pc = no_precond>
+    solve_result bicgstab(Op const& a, vec<T const, false> b, vec<T, false> x, Pc const& m = {}) {
+        size_t n = prepare(a, b, x, 7);
+        MATRIX_PROF_SCOPE_AS(prof, "bicgstab", n, n, 0, 0);
+        // Two products and about 24 vector passes with as many flops per element.
+        auto done = [&](solve_result r) {
+            MATRIX_PROF_ADD(prof, r.iters * ((2 * op_cost<T>(a).bytes) + (24 * n * sizeof(T))),
+                            r.iters * ((2 * op_cost<T>(a).flops) + (24 * n)));
+            return r;
+        };
+        auto r = wv(0, n), r0 = wv(1, n), p = wv(2, n), v = wv(3, n);
+        auto ph = wv(4, n), sh = wv(5, n), t = wv(6, n);
+        T bnorm = norm_or_one(b);
+
+        op_apply(a, x.as_const(), t);
+        T rr = sub_dot(b, t, r);
+        if (std::sqrt(rr) <= opts.tol * bnorm) return done({0, std::sqrt(rr) / bnorm, true});
+        memcpy(r0.ptr(), r.ptr(), n * sizeof(T));
+        v.zero_fill();
+        p.zero_fill();
+        T rho = 1, alpha = 1, omega = 1;
+        for (size_t it = 1; it <= opts.max_iter; it++) {
+            T rho_next = dot_nocklen(r0, r, opts.sum);
+            if (rho_next == 0) return done({it, std::sqrt(rr) / bnorm, false});
+            T beta = (rho_next / rho) * (alpha / omega);
+            axpy_nocklen(-omega, v, p);
+            axpby_nocklen(T {1}, r, beta, p);
+            m.apply(p.as_const(), ph);
+            op_apply(a, ph.as_const(), v);
+            alpha = rho_next / dot_nocklen(r0, v, opts.sum);
+            T ss = axpy_dot_nocklen(-alpha, v, r, r, opts.sum); // r now holds s
+            if (std::sqrt(ss) <= opts.tol * bnorm) {
+                axpy_nocklen(alpha, ph, x);
+                return done({it, std::sqrt(ss) / bnorm, true});
+            }
+            m.apply(r.as_const(), sh);
+            op_apply(a, sh.as_const(), t);
+            T ts = dot_nocklen(t, r, opts.sum), tt = dot_nocklen(t, t, opts.sum);
+            omega = tt == 0 ? T {} : ts / tt;
+            axpy_nocklen(alpha, ph, x);
+            axpy_nocklen(omega, sh, x);
+            rr = axpy_dot_nocklen(-omega, t, r, r, opts.sum);
+            if (std::sqrt(rr) <= opts.tol * bnorm) return done({it, std::sqrt(rr) / bnorm, true});
+            if (omega == 0) return done({it, std::sqrt(rr) / bnorm, false});
+            rho = rho_next;
+        }
+        return done({opts.max_iter, std::sqrt(rr) / bnorm, false});
+    }
+    /// --- end stabilized biconjugate gradient ---
+
+    /// --- restarted generalized minimal residual ---
+    // Right-preconditioned GMRES(m) with modified Gram-Schmidt and Givens rotations.
+    template<linear_op<T> Op, preconditioner<T> Pc = no_precond>
+    solve_result gmres(Op const& a, vec<T const, false> b, vec<T, false> x, Pc const& m = {}) {
+        size_t k = std::max<size_t>(opts.restart, 1);
+        size_t n = prepare(a, b, x, k + 2);
+        MATRIX_PROF_SCOPE_AS(prof, "gmres", n, n, 0, 0);
+        // One product per iteration, and orthogonalization against about k / 2 basis vectors
+        // on average, at 3 vectors and 4 flops per element each.
+        auto done = [&](solve_result r) {
+            MATRIX_PROF_ADD(prof,
+                            r.iters * (op_cost<T>(a).bytes + (3 * ((k / 2) + 2) * n * sizeof(T))),
+                            r.iters * (op_cost<T>(a).flops + (4 * ((k / 2) + 2) * n)));
+            return r;
+        };
+        if (hess.n_rows() < k + 1 || hess.n_cols() < k + 3) hess = owned_col_mat<T>(k + 1, k + 3);
+        auto h  = [&](size_t i, size_t j) -> T& { return hess.col_ptr(j)[i]; };
+        T*   cs = hess.col_ptr(k), *sn = hess.col_ptr(k + 1), *g = hess.col_ptr(k + 2);
+        auto z  = wv(k + 1, n);
+        T bnorm = norm_or_one(b);
+
+        size_t it = 0;
+        T      resid {};
+        while (true) {
+            auto r = wv(0, n);
+            op_apply(a, x.as_const(), z);
+            resid = std::sqrt(sub_dot(b, z, r));
+            if (resid <= opts.tol * bnorm || it >= opts.max_iter)
+                return done({it, resid / bnorm, resid <= opts.tol * bnorm});
+            r /= resid;
+            std::fill(g, g + k + 1, T {});
+            g[0] = resid;
+
+            size_t j = 0;
+            while (j < k && it < opts.max_iter) {
+                auto w = wv(j + 1, n);
+                m.apply(wv(j, n).as_const(), z);
+                op_apply(a, z.as_const(), w);
+                h(0, j) = dot_nocklen(w, wv(0, n), opts.sum);
+                for (size_t i = 0; i < j; i++)
+                    h(i + 1, j) = axpy_dot_nocklen(-h(i, j), wv(i, n), w, wv(i + 1, n), opts.sum);
+                T hn = std::sqrt(axpy_dot_nocklen(-h(j, j), wv(j, n), w, w, opts.sum));
+                h(j + 1, j) = hn;
+                if (hn != 0) w /= hn;
+
+                for (size_t i = 0; i < j; i++) {
+                    T hi = h(i, j), hi1 = h(i + 1, j);
+                    h(i, j)     =  (cs[i] * hi) + (sn[i] * hi1);
+                    h(i + 1, j) = -(sn[i] * hi) + (cs[i] * hi1);
+                }
+                T d = std::hypot(h(j, j), h(j + 1, j));
+                cs[j] = d == 0 ? T {1} : h(j, j) / d;
+                sn[j] = d == 0 ? T {}  : h(j + 1, j) / d;
+                h(j, j) = d;
+                h(j + 1, j) = 0;
+                g[j + 1] = -sn[j] * g[j];
+                g[j]     =  cs[j] * g[j];
+                j++;
+                it++;
+                resid = std::abs(g[j]);
+                if (resid <= opts.tol * bnorm || hn == 0) break;
+            }
+
+            for (size_t i = j; i-- > 0;) {
+                for (size_t l = i + 1; l < j; l++) g[i] -= h(i, l) * g[l];
+                g[i] /= h(i, i);
+            }
+            auto u = wv(0, n); // V_0 is not needed anymore
+            u *= g[0];
+            for (size_t i = 1; i < j; i++) axpy_nocklen(g[i], wv(i, n), u);
+            m.apply(u.as_const(), z);
+            axpy_nocklen(T {1}, z, x);
+        }
+    }
+    /// --- end restarted generalized minimal residual ---
+
+private:
+    /// --- workspace ---
+    [[nodiscard]] vec<T, false> wv(size_t i, size_t n) const noexcept
+        { return vec<T, false>(work.col_ptr(i), n); }
+
+    template<typename Op>
+    size_t prepare(Op const& a, vec<T const, false> b, vec<T, false> x, size_t n_vecs) {
+        size_t n = b.len();
+        if (x.len() != n) throw vec_len_mismatch(n, x.len());
+        if constexpr (requires { a.n_rows(); a.n_cols(); }) {
+            if (a.n_rows() != n || a.n_cols() != n)
+                throw mat_size_mismatch(a.n_rows(), a.n_cols(), n, n);
+        }
+        if (work.n_rows() != n || work.n_cols() < n_vecs)
+            work = owned_col_mat<T>(n, n_vecs, false);
+        return n;
+    }
+    /// --- end workspace ---
+
+    /// --- vector kernels ---
+    T norm_or_one(vec<T const, false> b) const noexcept {
+        T s = nrm2(b, opts.sum);
+        return s == 0 ? T {1} : s;
+    }
+    // r = b - ax, returning r . r
+    T sub_dot(vec<T const, false> b, vec<T const, false> ax, vec<T, false> r) const noexcept {
+        memcpy(r.ptr(), b.ptr(), b.len() * sizeof(T));
+        return axpy_dot_nocklen(T {-1}, ax, r, r, opts.sum);
+    }
+    /// --- end vector kernels ---
+};
+/// --- end solvers ---
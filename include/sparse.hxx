@@ -0,0 +1,295 @@
+#pragma once
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include "par.hxx"
+#include "tune.hxx"
+#include <algorithm>
+#include <span>
+#include <vector>
+
+struct bad_sparse_structure : std::invalid_argument {
+    bad_sparse_structure(char const* what)
+        : std::invalid_argument(std::string("malformed sparse matrix: ") + what) {}
+};
+
+template<typename T> struct coo_entry final { size_t row, col; T val; };
+
+// Compressed sparse matrix, CSR for mat_maj::row and CSC for mat_maj::col.
+// Minor indices are kept sorted and unique within every majvec.
+template<typename T, mat_maj maj> requires (!std::is_const_v<T>)
+struct sparse_mat final {
+protected:
+    /// --- fields ---
+    size_t              rows {};
+    size_t              cols {};
+    std::vector<size_t> ptr;  // n_maj() + 1 offsets into idx and val
+    std::vector<size_t> idx;  // minor index of every stored element
+    std::vector<T>      val;
+    /// --- end fields ---
+
+    // Below this many stored elements products run on the calling thread only.
+    [[nodiscard]] static size_t par_grain() { return tuned().sparse_grain; }
+
+public:
+    /// --- constructors ---
+    sparse_mat() : ptr(1) {}
+    explicit sparse_mat(size_t rows, size_t cols)
+        : rows(rows), cols(cols), ptr(n_maj() + 1) {}
+
+    explicit sparse_mat(size_t rows, size_t cols, // NOLINT (easily swapped)
+                        std::vector<size_t> ptr, std::vector<size_t> idx, std::vector<T> val)
+        : rows(rows), cols(cols), ptr(std::move(ptr)), idx(std::move(idx)), val(std::move(val)) {
+        if (this->ptr.size() != n_maj() + 1)     throw bad_sparse_structure("wrong offset count");
+        if (this->ptr.front() != 0)               throw bad_sparse_structure("nonzero first offset");
+        if (this->ptr.back() != this->idx.size()) throw bad_sparse_structure("wrong last offset");
+        if (this->idx.size() != this->val.size()) throw bad_sparse_structure("index/value mismatch");
+        for (size_t i = 0; i < n_maj(); i++) {
+            if (this->ptr[i] > this->ptr[i + 1]) throw bad_sparse_structure("decreasing offsets");
+            for (size_t k = this->ptr[i]; k < this->ptr[i + 1]; k++) {
+                if (this->idx[k] >= n_min()) throw bad_sparse_structure("index out of bounds");
+                if (k > this->ptr[i] && this->idx[k] <= this->idx[k - 1])
+                    throw bad_sparse_structure("unsorted or repeated index");
+            }
+        }
+    }
+
+    // Takes the arrays as they are, for callers that produce a valid structure themselves.
+    [[nodiscard]] static sparse_mat from_parts_nocklen(size_t rows, size_t cols, // NOLINT
+                                                       std::vector<size_t> ptr,
+                                                       std::vector<size_t> idx,
+                                                       std::vector<T>      val) noexcept {
+        sparse_mat m;
+        m.rows = rows;
+        m.cols = cols;
+        m.ptr  = std::move(ptr);
+        m.idx  = std::move(idx);
+        m.val  = std::move(val);
+        return m;
+    }
+
+    // Keeps the nonzero elements of a dense matrix.
+    template<typename U, mat_maj om>
+    explicit sparse_mat(mat<U, om> d) : sparse_mat(d.n_rows(), d.n_cols()) {
+        size_t maj_s = maj == mat_maj::col ? d.col_stride() : d.row_stride();
+        size_t min_s = maj == mat_maj::col ? d.row_stride() : d.col_stride();
+        for (size_t i = 0; i < n_maj(); i++) {
+            U const* v = d.base_ptr() + (i * maj_s);
+            for (size_t j = 0; j < n_min(); j++) {
+                if (v[j * min_s] == U {}) continue;
+                idx.push_back(j);
+                val.push_back(v[j * min_s]);
+            }
+            ptr[i + 1] = idx.size();
+        }
+    }
+
+    // Builds the matrix from unordered entries; repeated coordinates are summed.
+    [[nodiscard]] static sparse_mat from_entries(size_t rows, size_t cols,
+                                                 std::vector<coo_entry<T>> const& es) {
+        sparse_mat m(rows, cols);
+        for (auto const& e : es) {
+            if (e.row >= rows) throw mat_out_of_bounds(e.row, false);
+            if (e.col >= cols) throw mat_out_of_bounds(e.col, true);
+            m.ptr[maj_of(e) + 1]++;
+        }
+        for (size_t i = 0; i < m.n_maj(); i++) m.ptr[i + 1] += m.ptr[i];
+
+        std::vector<size_t> fill(m.ptr.begin(), m.ptr.end() - 1);
+        std::vector<std::pair<size_t, T>> tmp(es.size());
+        for (auto const& e : es) tmp[fill[maj_of(e)]++] = {min_of(e), e.val};
+
+        m.idx.reserve(es.size());
+        m.val.reserve(es.size());
+        for (size_t i = 0; i < m.n_maj(); i++) {
+            auto first = tmp.begin() + m.ptr[i], last = tmp.begin() + m.ptr[i + 1];
+            std::sort(first, last, [](auto const& a, auto const& b) { return a.first < b.first; });
+            m.ptr[i] = m.idx.size();
+            for (auto it = first; it != last; ++it) {
+                if (it != first && it->first == m.idx.back()) m.val.back() += it->second;
+                else { m.idx.push_back(it->first); m.val.push_back(it->second); }
+            }
+        }
+        m.ptr[m.n_maj()] = m.idx.size();
+        return m;
+    }
+    /// --- end constructors ---
+
+    /// --- accessors ---
+    [[nodiscard]] size_t n_rows() const noexcept { return rows; }
+    [[nodiscard]] size_t n_cols() const noexcept { return cols; }
+    [[nodiscard]] size_t n_maj () const noexcept { return maj==mat_maj::col?n_cols():n_rows(); }
+    [[nodiscard]] size_t n_min () const noexcept { return maj==mat_maj::col?n_rows():n_cols(); }
+    [[nodiscard]] size_t nnz   () const noexcept { return idx.size(); }
+
+    [[nodiscard]] std::span<size_t const> offsets() const noexcept { return ptr; }
+    [[nodiscard]] std::span<size_t const> indices() const noexcept { return idx; }
+    [[nodiscard]] std::span<T const>      values () const noexcept { return val; }
+    [[nodiscard]] std::span<T>            values ()       noexcept { return val; }
+
+    // Stored value at the given coordinates, or zero.
+    [[nodiscard]] T at(size_t row, size_t col) const {
+        if (row >= rows) throw mat_out_of_bounds(row, false);
+        if (col >= cols) throw mat_out_of_bounds(col, true);
+        size_t i = maj == mat_maj::col ? col : row, j = maj == mat_maj::col ? row : col;
+        auto first = idx.begin() + ptr[i], last = idx.begin() + ptr[i + 1];
+        auto it = std::lower_bound(first, last, j);
+        return it != last && *it == j ? val[it - idx.begin()] : T {};
+    }
+    /// --- end accessors ---
+
+    /// --- conversions ---
+    template<mat_maj m>
+    [[nodiscard]] sparse_mat<T, m> with_maj() const {
+        if constexpr (m == maj) return *this;
+        else {
+            std::vector<size_t> tptr(n_min() + 1), tidx(nnz());
+            std::vector<T>      tval(nnz());
+            for (size_t j : idx) tptr[j + 1]++;
+            for (size_t j = 0; j < n_min(); j++) tptr[j + 1] += tptr[j];
+            std::vector<size_t> fill(tptr.begin(), tptr.end() - 1);
+            for (size_t i = 0; i < n_maj(); i++) {
+                for (size_t k = ptr[i]; k < ptr[i + 1]; k++) {
+                    size_t dst = fill[idx[k]]++;
+                    tidx[dst] = i;
+                    tval[dst] = val[k];
+                }
+            }
+            return sparse_mat<T, m>::from_parts_nocklen(rows, cols, std::move(tptr),
+                                                        std::move(tidx), std::move(tval));
+        }
+    }
+
+    template<mat_maj om = maj>
+    [[nodiscard]] owned_mat<T, om> to_dense() const {
+        owned_mat<T, om> d(rows, cols);
+        for (size_t i = 0; i < n_maj(); i++) {
+            for (size_t k = ptr[i]; k < ptr[i + 1]; k++) {
+                if constexpr (maj == mat_maj::row) d.row_ptr(i)[d.col_idx(idx[k])] = val[k];
+                else                               d.col_ptr(i)[d.row_idx(idx[k])] = val[k];
+            }
+        }
+        return d;
+    }
+    /// --- end conversions ---
+
+    /// --- products with dense operands ---
+    // y := A x
+    template<typename OT, bool xhs, bool yhs>
+    void mul_vec_nocklen(vec<OT, xhs> x, vec<T, yhs> y) const {
+        MATRIX_PROF_SCOPE("spmv", rows, cols, (nnz() * (sizeof(T) + sizeof(size_t)))
+                                            + ((rows + cols) * sizeof(T)), 2 * nnz());
+        OT const* xp = x.ptr();
+        T*        yp = y.ptr();
+        size_t    xs = x.stride(), ys = y.stride();
+        if constexpr (maj == mat_maj::row) {
+            par_for_balanced(rows, ptr.data(), par_grain(), [&](size_t r0, size_t r1) {
+                for (size_t r = r0; r < r1; r++) {
+                    T s {};
+                    for (size_t k = ptr[r]; k < ptr[r + 1]; k++) s += val[k] * xp[idx[k] * xs];
+                    yp[r * ys] = s;
+                }
+            });
+        } else {
+            // Columns scatter into all of y, so every part accumulates privately.
+            size_t parts = std::min(par_threads(), nnz() / par_grain());
+            if (parts <= 1 || par_nested()) {
+                scatter_cols(0, cols, xp, xs, yp, ys, true);
+                return;
+            }
+            std::vector<size_t> bounds(parts + 1, cols);
+            for (size_t p = 0; p < parts; p++) {
+                bounds[p] = std::lower_bound(ptr.begin(), ptr.end() - 1, nnz() * p / parts)
+                          - ptr.begin();
+            }
+            owned_col_mat<T> acc(rows, parts);
+            par_invoke(parts, [&](size_t p) {
+                scatter_cols(bounds[p], bounds[p + 1], xp, xs, acc.col_ptr(p), 1);
+            });
+            par_for(rows, 4096, [&](size_t r0, size_t r1) {
+                for (size_t r = r0; r < r1; r++) {
+                    T s {};
+                    for (size_t p = 0; p < parts; p++) s += acc.col_ptr(p)[r];
+                    yp[r * ys] = s;
+                }
+            });
+        }
+    }
+    template<typename OT, bool xhs, bool yhs>
+    void mul_vec(vec<OT, xhs> x, vec<T, yhs> y) const {
+        if (x.len() != cols) throw vec_len_mismatch(cols, x.len());
+        if (y.len() != rows) throw vec_len_mismatch(rows, y.len());
+        mul_vec_nocklen(x, y);
+    }
+    template<typename OT, bool xhs>
+    [[nodiscard]] owned_vec<T> operator *(vec<OT, xhs> x) const {
+        owned_vec<T> y(rows, false);
+        mul_vec(x, y.as_ref());
+        return y;
+    }
+
+    // c := A b
+    template<typename OT, mat_maj bm, mat_maj cm>
+    void mul_mat_nocklen(mat<OT, bm> b, mat<T, cm> c) const {
+        size_t n = b.n_cols();
+        MATRIX_PROF_SCOPE("spmm", rows, n, (nnz() * (sizeof(T) + sizeof(size_t)))
+                                         + ((rows + cols) * n * sizeof(T)), 2 * nnz() * n);
+        OT const* bp = b.base_ptr();
+        T*        cp = c.base_ptr();
+        size_t    brs = b.row_stride(), bcs = b.col_stride();
+        size_t    crs = c.row_stride(), ccs = c.col_stride();
+        if constexpr (maj == mat_maj::row) {
+            size_t grain = par_grain() / std::max<size_t>(n, 1);
+            par_for_balanced(rows, ptr.data(), grain, [&](size_t r0, size_t r1) {
+                for (size_t r = r0; r < r1; r++) {
+                    T* cr = cp + (r * crs);
+                    for (size_t j = 0; j < n; j++) cr[j * ccs] = T {};
+                    for (size_t k = ptr[r]; k < ptr[r + 1]; k++) {
+                        T v = val[k];
+                        OT const* br = bp + (idx[k] * brs);
+                        for (size_t j = 0; j < n; j++) cr[j * ccs] += v * br[j * bcs];
+                    }
+                }
+            });
+        } else {
+            size_t grain = std::max<size_t>(1, par_grain() / (nnz() + 1));
+            par_for(n, grain, [&](size_t j0, size_t j1) {
+                for (size_t j = j0; j < j1; j++)
+                    scatter_cols(0, cols, bp + (j * bcs), brs, cp + (j * ccs), crs, true);
+            });
+        }
+    }
+    template<typename OT, mat_maj bm, mat_maj cm>
+    void mul_mat(mat<OT, bm> b, mat<T, cm> c) const {
+        if (b.n_rows() != cols) throw mat_size_mismatch(rows, cols, b.n_rows(), b.n_cols());
+        if (c.n_rows() != rows || c.n_cols() != b.n_cols())
+            throw mat_size_mismatch(rows, b.n_cols(), c.n_rows(), c.n_cols());
+        mul_mat_nocklen(b, c);
+    }
+    template<typename OT, mat_maj bm>
+    [[nodiscard]] owned_mat<T, bm> operator *(mat<OT, bm> b) const {
+        owned_mat<T, bm> c(rows, b.n_cols(), false);
+        mul_mat(b, c.as_ref());
+        return c;
+    }
+    /// --- end products with dense operands ---
+
+private:
+    static size_t maj_of(coo_entry<T> const& e) noexcept { return maj==mat_maj::col?e.col:e.row; }
+    static size_t min_of(coo_entry<T> const& e) noexcept { return maj==mat_maj::col?e.row:e.col; }
+
+    // y += A[:, c0..c1] x[c0..c1], zeroing y first when asked to. Columns with a zero x are
+    // skipped only for integral T: in floating point, 0 times a stored NaN or Inf is NaN, as
+    // in the row-major loops.
+    template<typename OT>
+    void scatter_cols(size_t c0, size_t c1, OT const* xp, size_t xs, T* yp, size_t ys,
+                      bool zero_y = false) const noexcept {
+        if (zero_y) for (size_t r = 0; r < rows; r++) yp[r * ys] = T {};
+        for (size_t c = c0; c < c1; c++) {
+            T xc = xp[c * xs];
+            if constexpr (std::is_integral_v<T>) if (xc == T {}) continue;
+            for (size_t k = ptr[c]; k < ptr[c + 1]; k++) yp[idx[k] * ys] += val[k] * xc;
+        }
+    }
+};
+template<typename T> using csr_mat = sparse_mat<T, mat_maj::row>;
+template<typename T> using csc_mat = sparse_mat<T, mat_maj::col>;
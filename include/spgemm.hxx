@@ -0,0 +1,156 @@
+#pragma once
+#include "sparse.hxx"
+#include <bit>
+
+// Two-phase sparse-sparse product over compressed storage.
+// Output majvec i is the sum of the right operand's majvecs selected by the left operand's
+// majvec i, which is the row-by-row Gustavson product for CSR and, since the CSC arrays of
+// X are the CSR arrays of X^T, the product C^T = B^T A^T for CSC.
+// Every majvec gets its own accumulator: a dense array indexed by minor index when its
+// estimated output is a sizable fraction of the minor dimension, a hash table otherwise.
+template<typename T>
+struct spgemm_kernel final {
+    /// --- fields ---
+    size_t                  n_maj, n_min;
+    std::span<size_t const> lptr, lidx, rptr, ridx;
+    std::span<T const>      lval, rval;
+    /// --- end fields ---
+
+    // Compressed arrays of the product.
+    struct parts final {
+        std::vector<size_t> ptr, idx;
+        std::vector<T>      val;
+    };
+
+    [[nodiscard]] parts run() const {
+        parts o;
+        std::vector<size_t> flops(n_maj + 1);
+        for (size_t i = 0; i < n_maj; i++) {
+            size_t f = 0;
+            for (size_t k = lptr[i]; k < lptr[i + 1]; k++)
+                f += rptr[lidx[k] + 1] - rptr[lidx[k]];
+            flops[i + 1] = flops[i] + f;
+        }
+
+        // Symbolic phase: exact output size of every majvec.
+        o.ptr.assign(n_maj + 1, 0);
+        par_for_balanced(n_maj, flops.data(), par_grain(), [&](size_t i0, size_t i1) {
+            accumulator acc(*this, o);
+            for (size_t i = i0; i < i1; i++)
+                o.ptr[i + 1] = acc.gather(i, flops[i + 1] - flops[i], false);
+        });
+        for (size_t i = 0; i < n_maj; i++) o.ptr[i + 1] += o.ptr[i];
+
+        // Numeric phase: values, with minor indices sorted.
+        o.idx.resize(o.ptr[n_maj]);
+        o.val.resize(o.ptr[n_maj]);
+        par_for_balanced(n_maj, flops.data(), par_grain(), [&](size_t i0, size_t i1) {
+            accumulator acc(*this, o);
+            for (size_t i = i0; i < i1; i++) acc.gather(i, flops[i + 1] - flops[i], true);
+        });
+        return o;
+    }
+
+private:
+    [[nodiscard]] static size_t par_grain() { return tuned().sparse_grain; }
+    static constexpr size_t npos      = SIZE_MAX;
+
+    struct accumulator final {
+        spgemm_kernel const& k;
+        parts&               o;
+        std::vector<size_t>  mark, keys, cols; // dense stamps, hash keys, gathered indices
+        std::vector<T>       dense, hvals;
+        size_t               stamp {};
+
+        accumulator(spgemm_kernel const& k, parts& o) : k(k), o(o) {}
+
+        // Accumulates output majvec i and returns its length; writes it out when numeric.
+        size_t gather(size_t i, size_t bound, bool numeric) {
+            if (bound == 0) return 0;
+            if (bound * 16 > k.n_min) return gather_dense(i, numeric);
+            return gather_hash(i, bound, numeric);
+        }
+
+        size_t gather_dense(size_t i, bool numeric) {
+            if (mark.empty()) { mark.assign(k.n_min, npos); dense.resize(k.n_min); }
+            cols.clear();
+            stamp++;
+            for_each_product(i, [&](size_t j, T v) {
+                if (mark[j] != stamp) { mark[j] = stamp; dense[j] = v; cols.push_back(j); }
+                else dense[j] += v;
+            });
+            if (numeric) {
+                std::sort(cols.begin(), cols.end());
+                size_t out = o.ptr[i];
+                for (size_t j : cols) { o.idx[out] = j; o.val[out] = dense[j]; out++; }
+            }
+            return cols.size();
+        }
+
+        size_t gather_hash(size_t i, size_t bound, bool numeric) {
+            size_t cap = std::bit_ceil(std::max<size_t>(2 * bound, 2)), mask = cap - 1;
+            int shift = 64 - std::countr_zero(cap);
+            keys.assign(cap, npos);
+            if (numeric) hvals.assign(cap, T {});
+            cols.clear();
+            for_each_product(i, [&](size_t j, T v) {
+                // Fibonacci hashing: the top bits of the product depend on all bits of j,
+                // so strided columns spread out where the low bits would collide.
+                size_t h = size_t((uint64_t(j) * 0x9E3779B97F4A7C15ULL) >> shift);
+                while (keys[h] != npos && keys[h] != j) h = (h + 1) & mask;
+                if (keys[h] == npos) { keys[h] = j; cols.push_back(h); }
+                if (numeric) hvals[h] += v;
+            });
+            if (numeric) {
+                std::sort(cols.begin(), cols.end(),
+                          [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+                size_t out = o.ptr[i];
+                for (size_t h : cols) { o.idx[out] = keys[h]; o.val[out] = hvals[h]; out++; }
+            }
+            return cols.size();
+        }
+
+        template<typename F>
+        void for_each_product(size_t i, F&& f) const {
+            for (size_t a = k.lptr[i]; a < k.lptr[i + 1]; a++) {
+                size_t m  = k.lidx[a];
+                T      lv = k.lval[a];
+                for (size_t b = k.rptr[m]; b < k.rptr[m + 1]; b++) f(k.ridx[b], lv * k.rval[b]);
+            }
+        }
+    };
+};
+
+// Multiplications in the product whose output majvecs are selected by l, for profiling.
+template<typename T, mat_maj maj>
+[[nodiscard]] size_t spgemm_mults(sparse_mat<T, maj> const& l, sparse_mat<T, maj> const& r) {
+    auto   rptr = r.offsets();
+    size_t f    = 0;
+    for (size_t m : l.indices()) f += rptr[m + 1] - rptr[m];
+    return f;
+}
+
+// C = A B for two sparse matrices of the same storage order.
+template<typename T, mat_maj maj>
+[[nodiscard]] sparse_mat<T, maj> spgemm(sparse_mat<T, maj> const& a,
+                                        sparse_mat<T, maj> const& b) {
+    if (a.n_cols() != b.n_rows())
+        throw mat_size_mismatch(a.n_rows(), a.n_cols(), b.n_rows(), b.n_cols());
+    auto const& l = maj == mat_maj::row ? a : b;
+    auto const& r = maj == mat_maj::row ? b : a;
+    MATRIX_PROF_SCOPE("spgemm", a.n_rows(), b.n_cols(),
+                      (a.nnz() + b.nnz()) * (sizeof(T) + sizeof(size_t)), 2 * spgemm_mults(l, r));
+    spgemm_kernel<T> k {
+        .n_maj = l.n_maj(), .n_min = r.n_min(),
+        .lptr  = l.offsets(), .lidx = l.indices(), .rptr = r.offsets(), .ridx = r.indices(),
+        .lval  = l.values(), .rval = r.values(),
+    };
+    auto c = k.run();
+    return sparse_mat<T, maj>::from_parts_nocklen(a.n_rows(), b.n_cols(), std::move(c.ptr),
+                                                  std::move(c.idx), std::move(c.val));
+}
+
+template<typename T, mat_maj maj>
+[[nodiscard]] sparse_mat<T, maj> operator *(sparse_mat<T, maj> const& a,
+                                            sparse_mat<T, maj> const& b)
+    { return spgemm(a, b); }
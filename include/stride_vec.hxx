@@ -0,0 +1,291 @@
+#pragma once
+#include "blas1.hxx"
+#include <array>
+
+// Vector views whose stride is a template argument instead of a runtime field.
+// Interleaved data (complex pairs, RGB pixels, xyz points) has small fixed strides, and with
+// the stride known at compile time the loops below become shuffles and wide loads instead of
+// one scalar load per element. Runtime-stride vec views convert to these after a stride check
+// and back for free.
+
+struct bad_vec_stride : std::invalid_argument {
+    bad_vec_stride(size_t want, size_t got) : std::invalid_argument(mk_errmsg(want, got)) {}
+private:
+    static std::string mk_errmsg(size_t want, size_t got) {
+        std::stringstream s;
+        s << "vector stride is " << got << ", expected " << want;
+        return s.str();
+    }
+};
+
+template<size_t S> using stride_c = std::integral_constant<size_t, S>;
+
+template<typename T, size_t S> struct stride_vec;
+
+/// --- stride of a view ---
+// A stride_c for every stride known at compile time, a size_t otherwise.
+template<typename T, size_t S>
+[[nodiscard]] constexpr stride_c<S> view_stride(stride_vec<T, S> const&) noexcept { return {}; }
+template<typename T, bool hs>
+[[nodiscard]] constexpr auto view_stride(vec<T, hs> const& v) noexcept {
+    if constexpr (hs) return v.stride();
+    else              return stride_c<1> {};
+}
+
+template<typename V>
+concept strided_view = requires(V const& v) { v.ptr(); v.len(); view_stride(v); };
+/// --- end stride of a view ---
+
+/// --- stride kernels ---
+// Loops over two strided sequences, each stride being a size_t or a stride_c.
+struct stride_kernel final {
+    template<typename AS, typename BS>
+    static constexpr bool both_static = !std::is_same_v<AS, size_t> && !std::is_same_v<BS, size_t>;
+
+    template<typename A, typename AS, typename B, typename BS>
+    [[nodiscard]] static bool eq(size_t n, A* a, AS as, B* b, BS bs) noexcept {
+        // Whole blocks are compared without early exit so that they vectorize.
+        constexpr size_t blk = 64;
+        size_t i = 0;
+        for (; i + blk <= n; i += blk) {
+            bool diff = false;
+            for (size_t l = 0; l < blk; l++) diff |= a[(i + l) * as] != b[(i + l) * bs];
+            if (diff) return false;
+        }
+        for (; i < n; i++) if (a[i * as] != b[i * bs]) return false;
+        return true;
+    }
+
+    template<typename U, typename A, typename AS, typename B, typename BS>
+    [[nodiscard]] static U dot(size_t n, A* a, AS as, B* b, BS bs) noexcept {
+        auto f = [&](size_t i) { return a[i * as] * b[i * bs]; };
+        if constexpr (both_static<AS, BS>) return lane_sum<U>(n, f);
+        else                               return lane_sum<U, 4>(n, f);
+    }
+
+    template<typename A, typename AS, typename B, typename BS, typename F>
+    static void zip(size_t n, A* a, AS as, B* b, BS bs, F&& f) noexcept
+        { for (size_t i = 0; i < n; i++) f(a[i * as], b[i * bs]); }
+
+    template<typename A, typename AS, typename F>
+    static void each(size_t n, A* a, AS as, F&& f) noexcept
+        { for (size_t i = 0; i < n; i++) f(a[i * as]); }
+};
+/// --- end stride kernels ---
+
+template<typename T, size_t S>
+struct stride_vec {
+    static_assert(S > 0);
+
+protected:
+    friend stride_vec<T const, S>;
+
+    /// --- fields ---
+    T*     _ptr;
+    size_t _len;
+    /// --- end fields ---
+
+    template<strided_view O>
+    void assert_len_eq(O const& o) const
+        { if (_len != o.len()) throw vec_len_mismatch(_len, o.len()); }
+
+public:
+    static constexpr bool is_mutable = !std::is_const_v<T>;
+
+    /// --- constructors and conversions ---
+    stride_vec() noexcept : _ptr(nullptr), _len(0) {}
+    explicit stride_vec(T* ptr, size_t len) noexcept : _ptr(ptr), _len(len) {}
+    template<bool hs>
+    explicit stride_vec(vec<T, hs> v) : _ptr(v.ptr()), _len(v.len())
+        { if (v.stride() != S) throw bad_vec_stride(S, v.stride()); }
+
+    [[nodiscard]] vec<T, true> as_vec() const noexcept { return vec<T, true>(_ptr, _len, S); }
+    [[nodiscard]] operator vec<T      , true>() const noexcept { return as_vec(); }
+    [[nodiscard]] operator vec<T const, true>() const noexcept requires is_mutable
+        { return as_vec().as_const(); }
+    /// --- end constructors and conversions ---
+
+    /// --- mutability and length conversions ---
+    [[nodiscard]] stride_vec<T const, S> as_const() const noexcept
+        { return stride_vec<T const, S>(_ptr, _len); }
+    [[nodiscard]] operator stride_vec<T const, S>() const noexcept requires is_mutable
+        { return as_const(); }
+
+    [[nodiscard]] stride_vec slice_nocklen(size_t start, size_t end) const noexcept
+        { return stride_vec(_ptr + (start * S), end - start); }
+    [[nodiscard]] stride_vec slice(size_t start, size_t end) const {
+        if (start > end || end > _len) throw bad_vec_slicing(start, end);
+        return slice_nocklen(start, end);
+    }
+    /// --- end mutability and length conversions ---
+
+    /// --- accessors ---
+    [[nodiscard]] T*     ptr() const noexcept { return _ptr; }
+    [[nodiscard]] size_t len() const noexcept { return _len; }
+    [[nodiscard]] static constexpr size_t stride() noexcept { return S; }
+
+    [[nodiscard]] T& operator [](size_t i) const {
+        if (i >= _len) throw vec_out_of_bounds(i);
+        return _ptr[i * S];
+    }
+    /// --- end accessors ---
+
+    /// --- comparison ---
+    template<strided_view O>
+    bool operator ==(O const& o) const noexcept
+        { return _len == o.len() && eq_nocklen(o); }
+    template<strided_view O>
+    bool eq_nocklen(O const& o) const noexcept
+        { return stride_kernel::eq(_len, _ptr, stride_c<S> {}, o.ptr(), view_stride(o)); }
+    /// --- end comparison ---
+
+    /// --- in-place modification ---
+    stride_vec const& fill(T v) const noexcept requires is_mutable {
+        stride_kernel::each(_len, _ptr, stride_c<S> {}, [&](T& a) { a = v; });
+        return *this;
+    }
+
+    template<strided_view O>
+    stride_vec const& copy_from_nocklen(O const& o) const noexcept requires is_mutable {
+        stride_kernel::zip(_len, _ptr, stride_c<S> {}, o.ptr(), view_stride(o),
+                           [](T& a, auto const& b) { a = b; });
+        return *this;
+    }
+    template<strided_view O>
+    stride_vec const& copy_from(O const& o, bool zero_rest = true) const noexcept
+    requires is_mutable {
+        if (_ptr == o.ptr()) return *this;
+        size_t copylen = std::min(_len, o.len());
+        slice_nocklen(0, copylen).copy_from_nocklen(o);
+        if (zero_rest) slice_nocklen(copylen, _len).fill(T {});
+        return *this;
+    }
+    /// --- end in-place modification ---
+
+    /// --- in-place arithmetic with length unsafety ---
+    template<strided_view O>
+    stride_vec const& add_assign_nocklen(O const& o) const noexcept requires is_mutable {
+        stride_kernel::zip(_len, _ptr, stride_c<S> {}, o.ptr(), view_stride(o),
+                           [](T& a, auto const& b) { a += b; });
+        return *this;
+    }
+    template<strided_view O>
+    stride_vec const& sub_assign_nocklen(O const& o) const noexcept requires is_mutable {
+        stride_kernel::zip(_len, _ptr, stride_c<S> {}, o.ptr(), view_stride(o),
+                           [](T& a, auto const& b) { a -= b; });
+        return *this;
+    }
+    template<strided_view O>
+    std::remove_const_t<T> dot_nocklen(O const& o) const noexcept {
+        return stride_kernel::dot<std::remove_const_t<T>>(_len, _ptr, stride_c<S> {},
+                                                          o.ptr(), view_stride(o));
+    }
+    /// --- end in-place arithmetic with length unsafety ---
+
+    /// --- in-place arithmetic ---
+    template<strided_view O>
+    stride_vec const& operator +=(O const& o) const requires is_mutable {
+        assert_len_eq(o);
+        MATRIX_PROF_SCOPE("stride_vec.add_assign", _len, 1, 3 * _len * sizeof(T), _len);
+        return add_assign_nocklen(o);
+    }
+    template<strided_view O>
+    stride_vec const& operator -=(O const& o) const requires is_mutable {
+        assert_len_eq(o);
+        MATRIX_PROF_SCOPE("stride_vec.sub_assign", _len, 1, 3 * _len * sizeof(T), _len);
+        return sub_assign_nocklen(o);
+    }
+
+    stride_vec const& operator +=(T v) const noexcept requires is_mutable {
+        MATRIX_PROF_SCOPE("stride_vec.add_scalar", _len, 1, 2 * _len * sizeof(T), _len);
+        stride_kernel::each(_len, _ptr, stride_c<S> {}, [&](T& a) { a += v; });
+        return *this;
+    }
+    stride_vec const& operator -=(T v) const noexcept requires is_mutable {
+        MATRIX_PROF_SCOPE("stride_vec.sub_scalar", _len, 1, 2 * _len * sizeof(T), _len);
+        stride_kernel::each(_len, _ptr, stride_c<S> {}, [&](T& a) { a -= v; });
+        return *this;
+    }
+    stride_vec const& operator *=(T v) const noexcept requires is_mutable {
+        MATRIX_PROF_SCOPE("stride_vec.mul_scalar", _len, 1, 2 * _len * sizeof(T), _len);
+        stride_kernel::each(_len, _ptr, stride_c<S> {}, [&](T& a) { a *= v; });
+        return *this;
+    }
+    stride_vec const& operator /=(T v) const noexcept requires is_mutable {
+        MATRIX_PROF_SCOPE("stride_vec.div_scalar", _len, 1, 2 * _len * sizeof(T), _len);
+        stride_kernel::each(_len, _ptr, stride_c<S> {}, [&](T& a) { a /= v; });
+        return *this;
+    }
+
+    template<strided_view O>
+    std::remove_const_t<T> operator *(O const& o) const {
+        assert_len_eq(o);
+        MATRIX_PROF_SCOPE("stride_vec.dot", _len, 1, 2 * _len * sizeof(T), 2 * _len);
+        return dot_nocklen(o);
+    }
+    /// --- end in-place arithmetic ---
+};
+
+/// --- interleaved data ---
+// Splits n interleaved S-tuples into the S views of their components,
+// e.g. deinterleave<3>(pixels) gives the R, G and B channels of packed RGB data.
+template<size_t S, typename T>
+[[nodiscard]] std::array<stride_vec<T, S>, S> deinterleave(vec<T, false> v) {
+    if (v.len() % S != 0) throw vec_len_mismatch(v.len(), (v.len() / S) * S);
+    std::array<stride_vec<T, S>, S> parts;
+    for (size_t c = 0; c < S; c++) parts[c] = stride_vec<T, S>(v.ptr() + c, v.len() / S);
+    return parts;
+}
+/// --- end interleaved data ---
+
+/// --- level-1 BLAS ---
+// Same contracts as the vec overloads in blas1.hxx.
+template<typename A, typename XT, size_t XS, typename YT, size_t YS>
+requires (!std::is_const_v<YT>)
+void axpy_nocklen(A a, stride_vec<XT, XS> x, stride_vec<YT, YS> y) noexcept {
+    stride_kernel::zip(x.len(), y.ptr(), stride_c<YS> {}, x.ptr(), stride_c<XS> {},
+                       [&](YT& yi, XT& xi) { yi += a * xi; });
+}
+template<typename A, typename XT, size_t XS, typename YT, size_t YS>
+requires (!std::is_const_v<YT>)
+void axpby_nocklen(A a, stride_vec<XT, XS> x, A b, stride_vec<YT, YS> y) noexcept {
+    stride_kernel::zip(x.len(), y.ptr(), stride_c<YS> {}, x.ptr(), stride_c<XS> {},
+                       [&](YT& yi, XT& xi) { yi = (a * xi) + (b * yi); });
+}
+template<typename A, typename XT, size_t XS, typename YT, size_t YS>
+requires (!std::is_const_v<YT>)
+void axpy(A a, stride_vec<XT, XS> x, stride_vec<YT, YS> y) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    MATRIX_PROF_SCOPE("axpy", x.len(), 1, x.len() * (sizeof(XT) + (2 * sizeof(YT))), 2 * x.len());
+    axpy_nocklen(a, x, y);
+}
+template<typename A, typename XT, size_t XS, typename YT, size_t YS>
+requires (!std::is_const_v<YT>)
+void axpby(A a, stride_vec<XT, XS> x, A b, stride_vec<YT, YS> y) {
+    if (x.len() != y.len()) throw vec_len_mismatch(x.len(), y.len());
+    MATRIX_PROF_SCOPE("axpby", x.len(), 1, x.len() * (sizeof(XT) + (2 * sizeof(YT))), 3 * x.len());
+    axpby_nocklen(a, x, b, y);
+}
+template<typename A, typename T, size_t S> requires (!std::is_const_v<T>)
+void scal(A a, stride_vec<T, S> x) noexcept {
+    MATRIX_PROF_SCOPE("scal", x.len(), 1, 2 * x.len() * sizeof(T), x.len());
+    stride_kernel::each(x.len(), x.ptr(), stride_c<S> {}, [&](T& v) { v *= a; });
+}
+
+template<typename T, size_t S>
+[[nodiscard]] std::remove_const_t<T> asum(stride_vec<T, S> x,
+                                          sum_mode m = sum_mode::fast) noexcept {
+    using U = std::remove_const_t<T>;
+    MATRIX_PROF_SCOPE("asum", x.len(), 1, x.len() * sizeof(T), 2 * x.len());
+    T* xp = x.ptr();
+    return lane_sum<U>(m, x.len(), [&](size_t i) { return U(std::abs(xp[i * S])); });
+}
+template<typename T, size_t S> requires std::is_floating_point_v<std::remove_const_t<T>>
+[[nodiscard]] std::remove_const_t<T> nrm2(stride_vec<T, S> x, sum_mode m = sum_mode::fast) noexcept
+    { return nrm2(x.as_vec(), m); }
+/// --- end level-1 BLAS ---
+
+/// --- printing ---
+template<typename T, size_t S> std::ostream& operator <<(std::ostream& o, stride_vec<T, S> v)
+    { return o << v.as_vec(); }
+/// --- end printing ---
@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Timeline of library calls in the Chrome Trace Event format, for chrome://tracing and
+// Perfetto. Every traced call is one complete ("X") event with its start, duration, thread,
+// shape, bytes and flops. Threads append to their own ring buffers without locking; a full
+// ring overwrites its oldest events. Flush once the traced work has finished: events
+// written while a flush reads the same ring slot may come out torn.
+
+/// --- events ---
+struct trace_event final {
+    char const* name;
+    uint64_t    t0_ns;
+    uint64_t    dur_ns;
+    uint64_t    bytes;
+    uint64_t    flops;
+    uint64_t    rows;
+    uint64_t    cols;
+};
+
+struct trace_ring final {
+    static constexpr size_t cap = size_t {1} << 14;
+
+    uint32_t              tid;
+    std::atomic<uint64_t> head {}; // events ever pushed
+    trace_event           ev[cap];
+
+    explicit trace_ring(uint32_t tid) noexcept : tid(tid) {}
+
+    void push(trace_event const& e) noexcept {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        ev[h & (cap - 1)] = e;
+        head.store(h + 1, std::memory_order_release);
+    }
+};
+
+[[nodiscard]] inline uint64_t trace_now_ns() noexcept {
+    static auto const epoch = std::chrono::steady_clock::now();
+    return uint64_t(std::chrono::nanoseconds(std::chrono::steady_clock::now() - epoch).count());
+}
+/// --- end events ---
+
+/// --- rings of all threads ---
+struct trace_registry final {
+    [[nodiscard]] static trace_registry& get() { static trace_registry r; return r; }
+
+    // A thread takes a free ring on its first event and hands it back when it exits, so
+    // the threads par_invoke starts on every call reuse rings instead of adding new ones.
+    // A ring keeps its events across owners until they are written or overwritten; its
+    // tid names the ring, i.e. one of the threads that traced at the same time.
+    [[nodiscard]] trace_ring& this_thread() {
+        thread_local ring_owner owner;
+        if (!owner.ring) owner.ring = acquire();
+        return *owner.ring;
+    }
+    // Rings ever created: the most threads that held one at the same time.
+    [[nodiscard]] size_t size() const {
+        std::lock_guard lk(mtx);
+        return rings.size();
+    }
+
+    void write_json(std::ostream& o) const {
+        std::lock_guard lk(mtx);
+        auto flags = o.flags();
+        auto prec  = o.precision();
+        o << std::fixed << std::setprecision(3); // timestamps are in microseconds
+        o << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+        bool first = true;
+        for (auto const& r : rings) {
+            uint64_t h = r->head.load(std::memory_order_acquire);
+            for (uint64_t i = h > trace_ring::cap ? h - trace_ring::cap : 0; i < h; i++) {
+                auto const& e = r->ev[i & (trace_ring::cap - 1)];
+                o << (first ? "\n" : ",\n") << "{\"name\": \"" << e.name
+                  << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << r->tid
+                  << ", \"ts\": " << double(e.t0_ns) / 1e3
+                  << ", \"dur\": " << double(e.dur_ns) / 1e3
+                  << ", \"args\": {\"rows\": " << e.rows << ", \"cols\": " << e.cols
+                  << ", \"bytes\": " << e.bytes << ", \"flops\": " << e.flops << "}}";
+                first = false;
+            }
+        }
+        o << "\n]}\n";
+        o.flags(flags);
+        o.precision(prec);
+    }
+    // Drops all recorded events.
+    void clear() {
+        std::lock_guard lk(mtx);
+        for (auto& r : rings) r->head.store(0, std::memory_order_release);
+    }
+
+private:
+    mutable std::mutex                       mtx;
+    std::vector<std::unique_ptr<trace_ring>> rings;
+    std::vector<trace_ring*>                 free_rings;
+
+    struct ring_owner final {
+        trace_ring* ring = nullptr;
+        ~ring_owner() { if (ring) trace_registry::get().release(ring); }
+    };
+    trace_ring* acquire() {
+        std::lock_guard lk(mtx);
+        if (!free_rings.empty()) {
+            trace_ring* r = free_rings.back();
+            free_rings.pop_back();
+            return r;
+        }
+        rings.push_back(std::make_unique<trace_ring>(uint32_t(rings.size() + 1)));
+        return rings.back().get();
+    }
+    void release(trace_ring* r) {
+        std::lock_guard lk(mtx);
+        free_rings.push_back(r);
+    }
+};
+/// --- end rings of all threads ---
+
+/// --- scopes ---
+// Records one event named site, a string literal, spanning its lifetime.
+struct trace_scope final {
+    trace_scope(char const* site, uint64_t rows, uint64_t cols, uint64_t bytes, uint64_t flops = 0)
+        : ring(trace_registry::get().this_thread()),
+          e {.name = site, .t0_ns = trace_now_ns(), .dur_ns = 0,
+             .bytes = bytes, .flops = flops, .rows = rows, .cols = cols} {}
+    ~trace_scope() { e.dur_ns = trace_now_ns() - e.t0_ns; ring.push(e); }
+    trace_scope(trace_scope const&) = delete;
+    trace_scope& operator =(trace_scope const&) = delete;
+
+    // Work only known once the scope has run, e.g. iterations of a solver.
+    void add(uint64_t bytes, uint64_t flops) noexcept { e.bytes += bytes; e.flops += flops; }
+
+private:
+    trace_ring& ring;
+    trace_event e;
+};
+/// --- end scopes ---
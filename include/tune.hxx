@@ -0,0 +1,142 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Blocking and parallel-grain parameters of the library's kernels. They are set once, on
+// first use, from the tuning file written by autotune() (autotune.hxx) when there is one,
+// and otherwise from heuristics over the cache sizes the kernel reports in sysfs.
+// The file is $MATRIX_TUNE_FILE, else $XDG_CONFIG_HOME/matrix/tune.conf, else
+// $HOME/.config/matrix/tune.conf; it holds one "key = value" line per parameter.
+
+struct tune_params final {
+    size_t gemv_block   = 2048;              // gemv cache block, elements of x or y
+    size_t qr_block     = 32;                // QR panel width, columns
+    size_t dense_grain  = size_t {1} << 15;  // multiply-adds per thread, dense kernels
+    size_t sparse_grain = size_t {1} << 14;  // stored elements or products per thread, sparse
+    size_t batch_grain  = size_t {1} << 16;  // multiply-adds per thread, gemm_batch
+
+    bool operator ==(tune_params const&) const = default;
+};
+
+/// --- cache sizes ---
+struct cache_sizes final {
+    size_t l1d {}, l2 {}, l3 {}; // bytes, 0 when unknown
+};
+
+// Reads the caches of the first CPU from sysfs (or a directory laid out the same way).
+[[nodiscard]] inline cache_sizes read_cache_sizes(
+    std::string const& dir = "/sys/devices/system/cpu/cpu0/cache") {
+    cache_sizes cs;
+    for (int i = 0; i < 16; i++) {
+        std::string idx = dir + "/index" + std::to_string(i) + "/";
+        std::ifstream fl(idx + "level"), ft(idx + "type"), fs(idx + "size");
+        int level = 0;
+        std::string type, size;
+        if (!(fl >> level) || !(ft >> type) || !(fs >> size)) continue;
+        size_t bytes = std::strtoull(size.c_str(), nullptr, 10);
+        switch (size.back()) {
+        case 'K': bytes <<= 10; break;
+        case 'M': bytes <<= 20; break;
+        case 'G': bytes <<= 30; break;
+        default:  break;
+        }
+        if (level == 1 && type == "Data") cs.l1d = bytes;
+        if (level == 2 && type != "Instruction") cs.l2 = bytes;
+        if (level == 3 && type != "Instruction") cs.l3 = bytes;
+    }
+    return cs;
+}
+
+// Blocks that keep a gemv block of x and its partial sums within half of L1,
+// and wider QR panels where L2 holds them.
+[[nodiscard]] inline tune_params heuristic_params(cache_sizes cs) noexcept {
+    tune_params p;
+    if (cs.l1d) p.gemv_block = std::clamp<size_t>(std::bit_floor(cs.l1d / 16), 256, 8192);
+    if (cs.l2)  p.qr_block   = cs.l2 >= (size_t {1} << 20) ? 64 : 32;
+    return p;
+}
+/// --- end cache sizes ---
+
+/// --- tuning files ---
+// Overrides the parameters named in the text; unknown keys and malformed lines are skipped.
+[[nodiscard]] inline tune_params parse_tune_file(std::istream& in, tune_params p = {}) {
+    std::string line;
+    while (std::getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::istringstream k(line.substr(0, eq)), v(line.substr(eq + 1));
+        std::string key;
+        size_t      val = 0;
+        if (!(k >> key) || !(v >> val) || val == 0) continue;
+        if      (key == "gemv_block"  ) p.gemv_block   = val;
+        else if (key == "qr_block"    ) p.qr_block     = val;
+        else if (key == "dense_grain" ) p.dense_grain  = val;
+        else if (key == "sparse_grain") p.sparse_grain = val;
+        else if (key == "batch_grain" ) p.batch_grain  = val;
+    }
+    return p;
+}
+inline void write_tune_file(std::ostream& o, tune_params const& p) {
+    o << "# matrix kernel parameters, written by autotune()\n"
+      << "gemv_block = "   << p.gemv_block   << '\n'
+      << "qr_block = "     << p.qr_block     << '\n'
+      << "dense_grain = "  << p.dense_grain  << '\n'
+      << "sparse_grain = " << p.sparse_grain << '\n'
+      << "batch_grain = "  << p.batch_grain  << '\n';
+}
+
+[[nodiscard]] inline std::string tune_file_path() {
+    if (char const* f = std::getenv("MATRIX_TUNE_FILE")) return f;
+    if (char const* x = std::getenv("XDG_CONFIG_HOME"); x && *x)
+        return std::string(x) + "/matrix/tune.conf";
+    if (char const* h = std::getenv("HOME"))
+        return std::string(h) + "/.config/matrix/tune.conf";
+    return {};
+}
+
+// What the library starts with: the tuning file if readable, the heuristics otherwise.
+[[nodiscard]] inline tune_params load_tune_params() {
+    tune_params base = heuristic_params(read_cache_sizes());
+    std::string path = tune_file_path();
+    std::ifstream f(path);
+    return f ? parse_tune_file(f, base) : base;
+}
+/// --- end tuning files ---
+
+/// --- current parameters ---
+// Published as immutable snapshots, so kernels on other threads always read a whole set,
+// even while set_tuned installs another. Replaced snapshots are kept until exit, as
+// readers may still hold them; they are small and only change when tuning.
+inline std::atomic<tune_params const*>& tuned_ref() {
+    static tune_params const initial = load_tune_params();
+    static std::atomic<tune_params const*> p {&initial};
+    return p;
+}
+[[nodiscard]] inline tune_params const& tuned()
+    { return *tuned_ref().load(std::memory_order_acquire); }
+// Zero fields keep their current value, as zero values in tuning files do; kernels divide
+// by the grains.
+inline void set_tuned(tune_params p) {
+    static std::vector<std::unique_ptr<tune_params const>> kept;
+    static std::mutex mtx;
+    std::lock_guard lk(mtx);
+    tune_params const& cur = tuned();
+    for (auto f : {&tune_params::gemv_block, &tune_params::qr_block, &tune_params::dense_grain,
+                   &tune_params::sparse_grain, &tune_params::batch_grain})
+        if (p.*f == 0) p.*f = cur.*f;
+    if (cur == p) return;
+    kept.push_back(std::make_unique<tune_params const>(p));
+    tuned_ref().store(kept.back().get(), std::memory_order_release);
+}
+/// --- end current parameters ---
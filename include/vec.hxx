@@ -1,5 +1,7 @@
 #pragma once
 #include "fwd.hxx"
+#include "prof.hxx"
+#include "simd.hxx"
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
@@ -68,7 +70,7 @@ protected:
 
     template<typename OT, bool ohs>
     void assert_len_eq(vec<OT, ohs> o) const
-        { if (_len != o._len) throw vec_len_mismatch(_len, o._len); }
+        { if (_len != o.len()) throw vec_len_mismatch(_len, o.len()); }
 
 public:
     static constexpr bool is_mutable = !std::is_const_v<T>;
@@ -83,7 +85,7 @@ public:
     /// --- mutability and length conversions ---
     [[nodiscard]] vec<T      , has_stride> as_ref  () const noexcept { return *this; }
     [[nodiscard]] vec<T const, has_stride> as_const() const noexcept
-        { return vec<T const, has_stride>(_ptr,_len); }
+        { return vec<T const, has_stride>(_ptr, _len, _stride); }
     [[nodiscard]] operator vec<T const, has_stride>() const noexcept { return as_const(); }
 
     [[nodiscard]] vec slice_from_nocklen(size_t start) const noexcept
@@ -121,12 +123,28 @@ public:
     /// --- comparison ---
     template<typename OT, bool ohs>
     bool operator ==(vec<OT, ohs> o) const noexcept {
-        if (_len != o._len) return false;
+        if (_len != o.len()) return false;
+        MATRIX_PROF_SCOPE("vec.eq", _len, 1, _len * (sizeof(T) + sizeof(OT)), 0);
         return eq_nocklen(o);
     }
     template<typename OT, bool ohs>
     bool eq_nocklen(vec<OT, ohs> o) const noexcept {
-        for (size_t i = 0; i < _len; i++) if (_ptr[i] != o._ptr[i]) return false;
+        T*     a  = _ptr;
+        OT*    b  = o.ptr();
+        size_t as = _stride, bs = o.stride();
+        if (as == 1 && bs == 1) {
+            // Whole blocks are compared without early exit so that they vectorize.
+            constexpr size_t blk = 64;
+            size_t i = 0;
+            for (; i + blk <= _len; i += blk) {
+                bool diff = false;
+                for (size_t l = 0; l < blk; l++) diff |= a[i + l] != b[i + l];
+                if (diff) return false;
+            }
+            for (; i < _len; i++) if (a[i] != b[i]) return false;
+            return true;
+        }
+        for (size_t n = _len; n; n--, a += as, b += bs) if (*a != *b) return false;
         return true;
     }
     /// --- end comparison ---
@@ -142,7 +160,8 @@ public:
     vec const& copy_from(vec<OT, ohs> o, bool zero_rest = true)
     const noexcept requires is_mutable {
         if (_ptr == o.ptr()) return *this;
-        size_t copylen = std::min(_len, o._len);
+        MATRIX_PROF_SCOPE("vec.copy_from", _len, 1, 2 * _len * sizeof(T), 0);
+        size_t copylen = std::min(_len, o.len());
         slice_to(copylen).copy_from_nocklen(o);
         if (zero_rest) for (size_t i = copylen; i < _len; i++) (*this)[i] = T {};
         return *this;
@@ -162,19 +181,28 @@ public:
     }
     template<typename OT, bool ohs>
     T dot_nocklen(vec<OT, ohs> o) const noexcept {
-        std::remove_const_t<T> rslt {};
-        for (size_t i = 0; i < _len; i++) rslt += _ptr[i] * o._ptr[i];
-        return rslt;
+        using U = std::remove_const_t<T>;
+        T*     a  = _ptr;
+        OT*    b  = o.ptr();
+        size_t as = _stride, bs = o.stride();
+        if (as == 1 && bs == 1) return lane_sum<U>(_len, [&](size_t i) { return a[i] * b[i]; });
+        return lane_sum<U, 4>(_len, [&](size_t i) { return a[i * as] * b[i * bs]; });
     }
     /// --- end in-place arithmetic with length unsafety ---
 
     /// --- in-place arithmetic ---
     template<typename OT, bool ohs>
-    vec const& operator +=(vec<OT, ohs> o) const requires is_mutable
-        { assert_len_eq(o); return add_assign_nocklen(o); }
+    vec const& operator +=(vec<OT, ohs> o) const requires is_mutable {
+        assert_len_eq(o);
+        MATRIX_PROF_SCOPE("vec.add_assign", _len, 1, 3 * _len * sizeof(T), _len);
+        return add_assign_nocklen(o);
+    }
     template<typename OT, bool ohs>
-    vec const& operator -=(vec<OT, ohs> o) const requires is_mutable
-        { assert_len_eq(o); return sub_assign_nocklen(o); }
+    vec const& operator -=(vec<OT, ohs> o) const requires is_mutable {
+        assert_len_eq(o);
+        MATRIX_PROF_SCOPE("vec.sub_assign", _len, 1, 3 * _len * sizeof(T), _len);
+        return sub_assign_nocklen(o);
+    }
 
     template<typename OT, bool ohs> vec& operator +(vec<OT, ohs>) = delete;
     template<typename OT, bool ohs> vec& operator -(vec<OT, ohs>) = delete;
@@ -183,22 +211,39 @@ public:
     vec& operator *(T) = delete;
     vec& operator /(T) = delete;
 
-    vec const& operator +=(T v) const noexcept requires is_mutable
-        { for (size_t i = 0; i < _len; i++) _ptr[i] += v; return *this; }
-    vec const& operator -=(T v) const noexcept requires is_mutable
-        { for (size_t i = 0; i < _len; i++) _ptr[i] -= v; return *this; }
-    vec const& operator *=(T v) const noexcept requires is_mutable
-        { for (size_t i = 0; i < _len; i++) _ptr[i] *= v; return *this; }
-    vec const& operator /=(T v) const noexcept requires is_mutable
-        { for (size_t i = 0; i < _len; i++) _ptr[i] /= v; return *this; }
+    vec const& operator +=(T v) const noexcept requires is_mutable {
+        MATRIX_PROF_SCOPE("vec.add_scalar", _len, 1, 2 * _len * sizeof(T), _len);
+        for (size_t i = 0; i < _len; i++) _ptr[i * _stride] += v;
+        return *this;
+    }
+    vec const& operator -=(T v) const noexcept requires is_mutable {
+        MATRIX_PROF_SCOPE("vec.sub_scalar", _len, 1, 2 * _len * sizeof(T), _len);
+        for (size_t i = 0; i < _len; i++) _ptr[i * _stride] -= v;
+        return *this;
+    }
+    vec const& operator *=(T v) const noexcept requires is_mutable {
+        MATRIX_PROF_SCOPE("vec.mul_scalar", _len, 1, 2 * _len * sizeof(T), _len);
+        for (size_t i = 0; i < _len; i++) _ptr[i * _stride] *= v;
+        return *this;
+    }
+    vec const& operator /=(T v) const noexcept requires is_mutable {
+        MATRIX_PROF_SCOPE("vec.div_scalar", _len, 1, 2 * _len * sizeof(T), _len);
+        for (size_t i = 0; i < _len; i++) _ptr[i * _stride] /= v;
+        return *this;
+    }
 
     template<typename OT, bool ohs>
-    T operator *(vec<OT, ohs> o) const { assert_len_eq(o); return dot_nocklen(o); }
+    T operator *(vec<OT, ohs> o) const {
+        assert_len_eq(o);
+        MATRIX_PROF_SCOPE("vec.dot", _len, 1, _len * (sizeof(T) + sizeof(OT)), 2 * _len);
+        return dot_nocklen(o);
+    }
     /// --- end in-place arithmetic ---
 };
 
 /// --- printing ---
 template<typename T, bool hs> std::ostream& operator <<(std::ostream& o, vec<T const, hs> v) {
+    MATRIX_PROF_SCOPE("vec.print", v.len(), 1, v.len() * sizeof(T), 0);
     for (size_t i = 0; i < v.len(); i++) o << std::setw(6) << v[i];
     return o;
 }
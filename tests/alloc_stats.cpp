@@ -0,0 +1,111 @@
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include "par.hxx"
+#include <gtest.h>
+#include <vector>
+
+// NOLINTBEGIN
+static alloc_usage tag_usage(char const* tag) {
+    auto s = alloc_registry::get().snapshot();
+    auto it = s.tags.find(tag);
+    return it == s.tags.end() ? alloc_usage {} : it->second;
+}
+
+TEST(alloc_stats, bookkeeping_tracks_live_and_peak) {
+    alloc_acct_if<true> a, b, c;
+    {
+        alloc_tag_scope t("test.book");
+        a.on_alloc(100);
+        b.on_alloc(50);
+    }
+    c.take(b);
+    a.on_free();
+    auto u = tag_usage("test.book");
+    ASSERT_EQ(u.live_bytes, 50);
+    ASSERT_EQ(u.peak_bytes, 150);
+    ASSERT_EQ(u.allocs, 2);
+    ASSERT_EQ(u.frees, 1);
+    b.on_free(); // gave its buffer away, so this is not a free
+    ASSERT_EQ(tag_usage("test.book").frees, 1);
+    c.on_free();
+    ASSERT_EQ(tag_usage("test.book").live_bytes, 0);
+    alloc_registry::get().reset_peaks();
+    ASSERT_EQ(tag_usage("test.book").peak_bytes, 0);
+}
+
+TEST(alloc_stats, empty_buffers_are_not_counted) {
+    alloc_acct_if<true> a;
+    {
+        alloc_tag_scope t("test.empty");
+        a.on_alloc(0);
+    }
+    a.on_free();
+    auto u = tag_usage("test.empty");
+    ASSERT_EQ(u.allocs, 0);
+    ASSERT_EQ(u.frees, 0);
+}
+
+TEST(alloc_stats, tag_scopes_nest) {
+    ASSERT_STREQ(alloc_tag_current(), "untagged");
+    {
+        alloc_tag_scope a("outer");
+        { alloc_tag_scope b("inner"); ASSERT_STREQ(alloc_tag_current(), "inner"); }
+        ASSERT_STREQ(alloc_tag_current(), "outer");
+    }
+    ASSERT_STREQ(alloc_tag_current(), "untagged");
+}
+
+TEST(alloc_stats, par_workers_take_the_callers_tag) {
+    size_t old = par_threads();
+    set_par_threads(4);
+    std::vector<char const*> seen(4);
+    {
+        alloc_tag_scope t("test.par");
+        par_for(4, 1, [&](size_t i0, size_t i1) {
+            for (size_t i = i0; i < i1; i++) seen[i] = alloc_tag_current();
+        });
+    }
+    set_par_threads(old);
+    for (auto s : seen) ASSERT_STREQ(s, "test.par");
+}
+
+#if defined(MATRIX_ALLOC_STATS)
+TEST(alloc_stats, owned_buffers_are_accounted) {
+    {
+        alloc_tag_scope t("test.owned");
+        owned_row_mat<double> m(10, 10);
+        owned_vec<int> v(8), e(0);
+        auto m2 = std::move(m);
+        owned_row_mat<double> m3(m2);
+        ASSERT_EQ(tag_usage("test.owned").live_bytes, (2 * 800) + 32);
+        m3 = owned_row_mat<double>(2, 2);
+        ASSERT_EQ(tag_usage("test.owned").live_bytes, 800 + 32 + 32);
+    }
+    auto u = tag_usage("test.owned");
+    ASSERT_EQ(u.live_bytes, 0);
+    ASSERT_EQ(u.allocs, u.frees);
+}
+
+TEST(alloc_stats, allocations_in_parallel_loops_are_tagged) {
+    size_t old = par_threads();
+    set_par_threads(4);
+    size_t untagged = tag_usage("untagged").allocs;
+    {
+        alloc_tag_scope t("test.par_for");
+        par_for(4, 1, [](size_t i0, size_t i1) {
+            for (size_t i = i0; i < i1; i++) owned_vec<double> v(16);
+        });
+    }
+    set_par_threads(old);
+    auto u = tag_usage("test.par_for");
+    ASSERT_EQ(u.allocs, 4);
+    ASSERT_EQ(u.live_bytes, 0);
+    ASSERT_EQ(tag_usage("untagged").allocs, untagged);
+}
+#else
+TEST(alloc_stats, compiled_out_costs_nothing) {
+    ASSERT_EQ(sizeof(owned_vec<int>), sizeof(vec<int, false>));
+    ASSERT_EQ(sizeof(owned_row_mat<int>), sizeof(row_mat<int>));
+}
+#endif
+// NOLINTEND
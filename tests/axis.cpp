@@ -0,0 +1,111 @@
+#include "axis.hxx"
+#include <gtest.h>
+
+// NOLINTBEGIN
+template<mat_maj maj>
+static owned_mat<double, maj> numbered(size_t rows, size_t cols) {
+    owned_mat<double, maj> m(rows, cols);
+    for (size_t i = 0; i < rows; i++) for (size_t j = 0; j < cols; j++)
+        m[i][j] = double((i * 7 + j * 3) % 11) - 5;
+    return m;
+}
+
+template<mat_maj maj>
+static void check_axes(size_t rows, size_t cols) {
+    auto a = numbered<maj>(rows, cols);
+    auto rs = row_sums(a.as_const()), rm = row_means(a.as_const());
+    auto rmin = row_mins(a.as_const()), rmax = row_maxs(a.as_const());
+    auto ram = row_argmax(a.as_const());
+    for (size_t i = 0; i < rows; i++) {
+        double s = 0, lo = a[i][0], hi = a[i][0];
+        size_t at = 0;
+        for (size_t j = 0; j < cols; j++) {
+            s += a[i][j];
+            lo = std::min(lo, a[i][j]);
+            if (a[i][j] > hi) { hi = a[i][j]; at = j; }
+        }
+        ASSERT_EQ(rs[i], s);
+        ASSERT_DOUBLE_EQ(rm[i], s / double(cols));
+        ASSERT_EQ(rmin[i], lo);
+        ASSERT_EQ(rmax[i], hi);
+        ASSERT_EQ(ram[i], at);
+    }
+    auto cs = col_sums(a.as_const()), cm = col_means(a.as_const());
+    auto cmin = col_mins(a.as_const()), cmax = col_maxs(a.as_const());
+    auto cam = col_argmax(a.as_const());
+    for (size_t j = 0; j < cols; j++) {
+        double s = 0, lo = a[0][j], hi = a[0][j];
+        size_t at = 0;
+        for (size_t i = 0; i < rows; i++) {
+            s += a[i][j];
+            lo = std::min(lo, a[i][j]);
+            if (a[i][j] > hi) { hi = a[i][j]; at = i; }
+        }
+        ASSERT_EQ(cs[j], s);
+        ASSERT_DOUBLE_EQ(cm[j], s / double(rows));
+        ASSERT_EQ(cmin[j], lo);
+        ASSERT_EQ(cmax[j], hi);
+        ASSERT_EQ(cam[j], at);
+    }
+}
+
+TEST(axis, reductions_of_both_orders) {
+    check_axes<mat_maj::row>(13, 9);
+    check_axes<mat_maj::col>(13, 9);
+    check_axes<mat_maj::row>(1, 300);
+    check_axes<mat_maj::col>(300, 1);
+}
+
+TEST(axis, parallel_paths) {
+    tune_params old = tuned();
+    size_t threads = par_threads();
+    tune_params p = old;
+    p.dense_grain = 16;
+    set_tuned(p);
+    set_par_threads(4);
+    check_axes<mat_maj::row>(2000, 5);   // columns split by rows, private accumulators
+    check_axes<mat_maj::col>(5, 2000);
+    check_axes<mat_maj::row>(300, 700);  // columns split by column ranges
+    check_axes<mat_maj::col>(700, 300);
+    check_axes<mat_maj::row>(2, 40);     // fewer majvecs than threads
+    set_tuned(old);
+    set_par_threads(threads);
+}
+
+TEST(axis, reproducible_sums_do_not_depend_on_thread_count) {
+    tune_params old = tuned();
+    size_t threads = par_threads();
+    tune_params p = old;
+    p.dense_grain = 16;
+    set_tuned(p);
+    set_par_reproducible(true);
+    owned_row_mat<float> a(5000, 3);
+    for (size_t i = 0; i < 5000; i++) for (size_t j = 0; j < 3; j++)
+        a[i][j] = 1.0f / float((i * 3) + j + 1);
+    set_par_threads(1);
+    auto first = col_sums(a.as_const());
+    for (size_t t : {2, 3, 8}) {
+        set_par_threads(t);
+        ASSERT_TRUE(col_sums(a.as_const()) == first.as_const());
+    }
+    set_par_reproducible(false);
+    set_tuned(old);
+    set_par_threads(threads);
+}
+
+TEST(axis, generic_reductions_and_empty_axes) {
+    owned_row_mat<int> a(3, 4);
+    for (size_t i = 0; i < 3; i++) for (size_t j = 0; j < 4; j++) a[i][j] = int(i + j);
+    auto prod = reduce_cols(a.as_const(), 1L, [](long x, long y) { return x * y; });
+    ASSERT_EQ(prod[0], 0);
+    ASSERT_EQ(prod[3], 3 * 4 * 5);
+    auto odd = reduce_rows(a.as_const(), 0, [](int x, int y) { return x | y; });
+    ASSERT_EQ(odd[2], 2 | 3 | 4 | 5);
+
+    owned_row_mat<double> e(2, 0);
+    ASSERT_EQ(row_sums(e.as_const())[1], 0);
+    ASSERT_EQ(row_maxs(e.as_const())[0], -std::numeric_limits<double>::infinity());
+    ASSERT_EQ(row_argmax(e.as_const())[0], 0);
+    ASSERT_EQ(col_sums(e.as_const()).len(), 0);
+}
+// NOLINTEND
@@ -0,0 +1,93 @@
+#include "batch.hxx"
+#include "owned_mat.hxx"
+#include <gtest.h>
+#include <vector>
+
+// NOLINTBEGIN
+template<mat_maj maj>
+static void check_batch(size_t count, size_t m, size_t k, size_t n) {
+    std::vector<owned_mat<double, maj>> as, bs, cs;
+    for (size_t i = 0; i < count; i++) {
+        as.emplace_back(m, k); bs.emplace_back(k, n); cs.emplace_back(m, n);
+        for (size_t r = 0; r < m; r++) for (size_t c = 0; c < k; c++) as[i][r][c] = double((i + r * 3 + c) % 7);
+        for (size_t r = 0; r < k; r++) for (size_t c = 0; c < n; c++) bs[i][r][c] = double((i * 2 + r + c * 5) % 5);
+    }
+    std::vector<mat<double const, maj>> av, bv;
+    std::vector<mat<double, maj>> cv;
+    for (size_t i = 0; i < count; i++) { av.push_back(as[i]); bv.push_back(bs[i]); cv.push_back(cs[i]); }
+    gemm_batch<double, maj>(av, bv, cv);
+    for (size_t i = 0; i < count; i++) for (size_t r = 0; r < m; r++) for (size_t c = 0; c < n; c++) {
+        double s = 0;
+        for (size_t l = 0; l < k; l++) s += as[i][r][l] * bs[i][l][c];
+        ASSERT_EQ(cs[i][r][c], s);
+    }
+}
+
+TEST(gemm_batch, specialized_sizes) {
+    for (size_t s : {2, 3, 4, 8, 16, 32}) {
+        check_batch<mat_maj::row>(9, s, s, s);
+        check_batch<mat_maj::col>(9, s, s, s);
+    }
+}
+TEST(gemm_batch, generic_shapes) {
+    check_batch<mat_maj::row>(5, 3, 7, 2);
+    check_batch<mat_maj::col>(5, 3, 7, 2);
+    check_batch<mat_maj::row>(3, 5, 5, 5);
+}
+TEST(gemm_batch, many_small_in_parallel) { check_batch<mat_maj::row>(5000, 4, 4, 4); }
+
+TEST(gemm_batch, strided_3d_batch) {
+    size_t count = 100, stride = 20;
+    std::vector<float> a(count * stride), b(count * stride), c(count * stride, -1);
+    for (size_t i = 0; i < a.size(); i++) { a[i] = float(i % 9); b[i] = float(i % 4); }
+    mat_batch<float const, mat_maj::col> ab {a.data(), count, 4, 4, stride}, bb {b.data(), count, 4, 4, stride};
+    mat_batch<float, mat_maj::col> cb {c.data(), count, 4, 4, stride};
+    gemm_batch(ab, bb, cb);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t r = 0; r < 4; r++) for (size_t col = 0; col < 4; col++) {
+            float s = 0;
+            for (size_t l = 0; l < 4; l++) s += ab[i].col(l)[r] * bb[i].col(col)[l];
+            ASSERT_EQ(cb[i].col(col)[r], s);
+        }
+        ASSERT_EQ(c[(i * stride) + 16], -1);
+    }
+}
+
+TEST(gemm_batch, non_const_operands) {
+    std::vector<owned_row_mat<double>> as, bs, cs;
+    std::vector<mat<double, mat_maj::row>> av, bv, cv;
+    for (size_t i = 0; i < 3; i++) {
+        as.emplace_back(2, 2); bs.emplace_back(2, 2); cs.emplace_back(2, 2);
+        as[i][0][0] = as[i][1][1] = double(i + 1);
+        bs[i][0][1] = bs[i][1][0] = 2;
+        av.push_back(as[i]); bv.push_back(bs[i]); cv.push_back(cs[i]);
+    }
+    gemm_batch<double, mat_maj::row>(av, bv, cv);
+    std::span<mat<double, mat_maj::row> const> as_span(av);
+    std::vector<mat<double const, mat_maj::row>> bcv(bv.begin(), bv.end());
+    std::span<mat<double const, mat_maj::row> const> bs_span(bcv);
+    gemm_batch(as_span, bs_span, std::span<mat<double, mat_maj::row> const>(cv));
+    for (size_t i = 0; i < 3; i++) {
+        ASSERT_EQ(cs[i][0][1], 2.0 * (i + 1));
+        ASSERT_EQ(cs[i][1][0], 2.0 * (i + 1));
+        ASSERT_EQ(cs[i][0][0], 0);
+    }
+
+    size_t count = 10, stride = 16;
+    std::vector<float> a(count * stride, 1), b(count * stride, 2), c(count * stride);
+    mat_batch<float, mat_maj::row> ab {a.data(), count, 4, 4, stride};
+    mat_batch<float, mat_maj::row> bb {b.data(), count, 4, 4, stride};
+    mat_batch<float, mat_maj::row> cb {c.data(), count, 4, 4, stride};
+    gemm_batch(ab, bb, cb);
+    for (float x : c) ASSERT_EQ(x, 8);
+}
+
+TEST(gemm_batch, mismatches_fail) {
+    owned_row_mat<double> a(2, 3), b(2, 3), c(2, 3);
+    std::vector<mat<double const, mat_maj::row>> av {a}, bv {b};
+    std::vector<mat<double, mat_maj::row>> cv {c};
+    ASSERT_THROW((gemm_batch<double, mat_maj::row>(av, bv, cv)), mat_size_mismatch);
+    bv.clear();
+    ASSERT_THROW((gemm_batch<double, mat_maj::row>(av, bv, cv)), batch_len_mismatch);
+}
+// NOLINTEND
@@ -0,0 +1,123 @@
+#include "blas1.hxx"
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include <gtest.h>
+
+// NOLINTBEGIN
+static owned_row_mat<double> numbered(size_t rows, size_t cols) {
+    owned_row_mat<double> m(rows, cols);
+    for (size_t i = 0; i < rows; i++) for (size_t j = 0; j < cols; j++) m[i][j] = (i * cols) + j;
+    return m;
+}
+
+TEST(blas1, axpy_contiguous_and_strided) {
+    auto m = numbered(5, 3);
+    owned_vec<double> y(5);
+    axpy(2.0, m.col(1).as_const(), y.as_ref());
+    for (size_t i = 0; i < 5; i++) ASSERT_EQ(y[i], 2.0 * (i * 3 + 1));
+    axpy(-1.0, y.as_const(), m.col(2));
+    for (size_t i = 0; i < 5; i++) ASSERT_EQ(m[i][2], (i * 3 + 2) - 2.0 * (i * 3 + 1));
+    owned_vec<double> z(4);
+    ASSERT_THROW(axpy(1.0, z.as_const(), y.as_ref()), vec_len_mismatch);
+}
+
+TEST(blas1, axpby_touches_only_the_view) {
+    auto m = numbered(4, 4);
+    axpby(1.0, m.col(0).as_const(), 3.0, m.col(3));
+    for (size_t i = 0; i < 4; i++) {
+        ASSERT_EQ(m[i][3], (i * 4.0) + 3 * (i * 4.0 + 3));
+        ASSERT_EQ(m[i][2], i * 4.0 + 2);
+    }
+}
+
+TEST(blas1, scal_strided) {
+    auto m = numbered(3, 2);
+    scal(10.0, m.col(1));
+    for (size_t i = 0; i < 3; i++) {
+        ASSERT_EQ(m[i][1], 10.0 * (i * 2 + 1));
+        ASSERT_EQ(m[i][0], i * 2.0);
+    }
+}
+
+TEST(blas1, axpy_dot_updates_and_reduces_in_one_pass) {
+    auto m = numbered(37, 3);
+    owned_vec<double> y(37), z(37);
+    for (size_t i = 0; i < 37; i++) { y[i] = 1.0; z[i] = i % 5; }
+    double want = 0;
+    for (size_t i = 0; i < 37; i++) want += (1.0 + 2.0 * (i * 3 + 1)) * (i % 5);
+    ASSERT_EQ(axpy_dot(2.0, m.col(1).as_const(), y.as_ref(), z.as_const()), want);
+    for (size_t i = 0; i < 37; i++) ASSERT_EQ(y[i], 1.0 + 2.0 * (i * 3 + 1));
+
+    // z may alias y, giving the squared norm of the update.
+    want = 0;
+    for (size_t i = 0; i < 37; i++) want += double((i * 3) + 3) * ((i * 3) + 3);
+    ASSERT_EQ(axpy_dot(-1.0, y.as_const(), m.col(0), m.col(0).as_const(), sum_mode::kahan), want);
+    owned_vec<double> w(4);
+    ASSERT_THROW((void)axpy_dot(1.0, w.as_const(), y.as_ref(), z.as_const()), vec_len_mismatch);
+}
+
+TEST(blas1, asum_and_iamax) {
+    owned_vec<double> v(37);
+    for (size_t i = 0; i < 37; i++) v[i] = (i % 2 ? -1.0 : 1.0) * i;
+    ASSERT_EQ(asum(v.as_const()), 36 * 37 / 2);
+    ASSERT_EQ(iamax(v.as_const()), 36);
+    v[5] = -100;
+    ASSERT_EQ(iamax(v.as_const()), 5);
+    auto m = numbered(6, 3);
+    ASSERT_EQ(asum(m.col(1).as_const()), 1 + 4 + 7 + 10 + 13 + 16);
+    ASSERT_EQ(iamax(m.col(1).as_const()), 5);
+    ASSERT_EQ(iamax(owned_vec<double>().as_const()), 0);
+}
+
+TEST(blas1, nrm2_is_overflow_and_underflow_safe) {
+    owned_vec<double> v(2);
+    v[0] = 3; v[1] = 4;
+    ASSERT_DOUBLE_EQ(nrm2(v.as_const()), 5);
+    v[0] = 3e200; v[1] = 4e200;
+    ASSERT_DOUBLE_EQ(nrm2(v.as_const()), 5e200);
+    v[0] = 3e-200; v[1] = 4e-200;
+    ASSERT_DOUBLE_EQ(nrm2(v.as_const()), 5e-200);
+    owned_vec<float> f(40);
+    f += 1e30f;
+    ASSERT_FLOAT_EQ(nrm2(f.as_const()), 1e30f * std::sqrt(40.0f));
+    auto m = numbered(2, 3);
+    ASSERT_DOUBLE_EQ(nrm2(m.col(2).as_const()), std::sqrt(2.0 * 2 + 5 * 5));
+}
+
+TEST(blas1, compensated_sums_recover_cancelled_terms) {
+    owned_vec<double> v(4);
+    v[0] = 1; v[1] = 1e100; v[2] = 1; v[3] = -1e100;
+    ASSERT_EQ(sum(v.as_const(), sum_mode::kahan), 2);
+    owned_vec<double> ones(4);
+    ones += 1;
+    ASSERT_EQ(dot(v.as_const(), ones.as_const(), sum_mode::kahan), 2);
+    vec<double, true> strided(v.ptr(), 2, 2);
+    ASSERT_EQ(sum(strided.as_const(), sum_mode::kahan), 2);
+    ASSERT_THROW((void)dot(v.as_const(), strided.as_const()), vec_len_mismatch);
+}
+
+TEST(blas1, accurate_sums_of_long_float_vectors) {
+    size_t n = size_t {1} << 22;
+    owned_vec<float> x(n, false), y(n, false);
+    double ref = 0, ref_dot = 0, ref_sq = 0;
+    for (size_t i = 0; i < n; i++) {
+        x[i] = 1.0f + (float(i % 1000) * 1e-4f);
+        y[i] = i % 2 ? 0.5f : 0.25f;
+        ref += x[i];
+        ref_dot += double(x[i]) * double(y[i]);
+        ref_sq += double(x[i]) * double(x[i]);
+    }
+    double eps = std::numeric_limits<float>::epsilon();
+    auto rel = [](double a, double b) { return std::abs(a - b) / std::abs(b); };
+    ASSERT_LE(rel(sum(x.as_const(), sum_mode::kahan), ref), eps);
+    ASSERT_LE(rel(sum(x.as_const(), sum_mode::pairwise), ref), 4 * eps);
+    ASSERT_LE(rel(dot(x.as_const(), y.as_const(), sum_mode::kahan), ref_dot), eps);
+    ASSERT_LE(rel(nrm2(x.as_const(), sum_mode::kahan), std::sqrt(ref_sq)), eps);
+    ASSERT_LE(rel(asum(x.as_const(), sum_mode::pairwise), ref), 4 * eps);
+    vec<float, true> evens(x.ptr(), n / 2, 2);
+    double ref_evens = 0;
+    for (size_t i = 0; i < n; i += 2) ref_evens += x[i];
+    ASSERT_LE(rel(sum(evens.as_const(), sum_mode::kahan), ref_evens), eps);
+    ASSERT_LE(rel(sum(evens.as_const(), sum_mode::pairwise), ref_evens), 4 * eps);
+}
+// NOLINTEND
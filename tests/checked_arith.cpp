@@ -0,0 +1,84 @@
+#include "checked_arith.hxx"
+#include <gtest.h>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// NOLINTBEGIN
+TEST(checked_arith, scalar) {
+    ASSERT_EQ(checked_sub(7, 3), 4);
+    ASSERT_EQ(checked_sub(int64_t {-5}, int64_t {5}), -10);
+    ASSERT_THROW((void)checked_sub(std::numeric_limits<int>::min(), 1), std::overflow_error);
+    ASSERT_THROW((void)checked_sub(size_t {1}, size_t {2}), std::bad_array_new_length);
+    ASSERT_THROW((void)checked_add(std::numeric_limits<int>::max(), 1), std::overflow_error);
+    ASSERT_THROW((void)checked_mul(size_t {1} << 33, size_t {1} << 31), std::bad_array_new_length);
+}
+
+TEST(checked_arith, sizes) {
+    size_t const n = 1000;
+    std::vector<size_t> rows(n), cols(n), bytes(n);
+    for (size_t i = 0; i < n; i++) { rows[i] = i * 7; cols[i] = (i * 13) + 1; }
+    checked_mul(n, rows.data(), cols.data(), bytes.data());
+    checked_mul(n, bytes.data(), sizeof(double), bytes.data());
+    for (size_t i = 0; i < n; i++) ASSERT_EQ(bytes[i], rows[i] * cols[i] * sizeof(double));
+
+    // Large operands take the exact path but do not overflow.
+    rows[500] = size_t {1} << 40;
+    cols[500] = size_t {1} << 20;
+    checked_mul(n, rows.data(), cols.data(), bytes.data());
+    ASSERT_EQ(bytes[500], size_t {1} << 60);
+    cols[500] = size_t {1} << 24;
+    ASSERT_THROW(checked_mul(n, rows.data(), cols.data(), bytes.data()),
+                 std::bad_array_new_length);
+}
+
+TEST(checked_arith, offsets) {
+    size_t const n = 700, ld = 1 << 20;
+    std::vector<size_t> row(n), col(n), off(n);
+    for (size_t i = 0; i < n; i++) { row[i] = i * 31; col[i] = i % ld; }
+    checked_mul_add(n, row.data(), ld, col.data(), off.data());
+    for (size_t i = 0; i < n; i++) ASSERT_EQ(off[i], (row[i] * ld) + col[i]);
+    checked_mul_add(n, row.data(), row.data(), col.data(), col.data()); // in place
+    for (size_t i = 0; i < n; i++) ASSERT_EQ(col[i], (row[i] * row[i]) + (i % ld));
+
+    row[n - 1] = std::numeric_limits<size_t>::max() / ld;
+    col[n - 1] = ld;
+    ASSERT_THROW(checked_mul_add(n, row.data(), ld, col.data(), off.data()),
+                 std::bad_array_new_length);
+}
+
+template<typename T>
+static void check_against_builtins() {
+    using lim = std::numeric_limits<T>;
+    std::vector<T> vals {0, 1, 2, 3, T(-1), T(-2), lim::max(), lim::min(), T(lim::max() / 2),
+                         T(lim::min() / 2), T(T(1) << (lim::digits / 2)),
+                         T(T(1) << ((lim::digits / 2) - 1)), T(-(T(1) << (lim::digits / 2)))};
+    for (T a : vals) for (T b : vals) {
+        T want;
+        T got;
+        if (__builtin_add_overflow(a, b, &want)) ASSERT_ANY_THROW(checked_add(1, &a, &b, &got));
+        else { checked_add(1, &a, &b, &got); ASSERT_EQ(got, want); }
+        if (__builtin_sub_overflow(a, b, &want)) ASSERT_ANY_THROW(checked_sub(1, &a, b, &got));
+        else { checked_sub(1, &a, b, &got); ASSERT_EQ(got, want); }
+        if (__builtin_mul_overflow(a, b, &want)) ASSERT_ANY_THROW(checked_mul(1, &a, &b, &got));
+        else { checked_mul(1, &a, &b, &got); ASSERT_EQ(got, want); }
+    }
+}
+
+TEST(checked_arith, matches_builtins) {
+    check_against_builtins<int8_t>();
+    check_against_builtins<uint16_t>();
+    check_against_builtins<int32_t>();
+    check_against_builtins<uint32_t>();
+    check_against_builtins<int64_t>();
+    check_against_builtins<uint64_t>();
+}
+
+TEST(checked_arith, signed_overflow_error) {
+    std::vector<int32_t> a(300, 1 << 20), b(300, 1 << 10), c(300);
+    checked_mul(a.size(), a.data(), b.data(), c.data());
+    ASSERT_EQ(c[299], 1 << 30);
+    b[299] = 1 << 11;
+    ASSERT_THROW(checked_mul(a.size(), a.data(), b.data(), c.data()), std::overflow_error);
+}
+// NOLINTEND
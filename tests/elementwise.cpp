@@ -0,0 +1,117 @@
+#include "elementwise.hxx"
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include <gtest.h>
+#include <vector>
+
+// NOLINTBEGIN
+template<mat_maj maj>
+static owned_mat<double, maj> numbered(size_t rows, size_t cols) {
+    owned_mat<double, maj> m(rows, cols);
+    for (size_t i = 0; i < rows; i++) for (size_t j = 0; j < cols; j++)
+        m[i][j] = double((i * 7 + j * 3) % 11) - 5;
+    return m;
+}
+
+// Small grains so that the tests run the parallel paths.
+struct ewise_par {
+    tune_params old = tuned();
+    size_t      threads = par_threads();
+    ewise_par() {
+        tune_params p = old;
+        p.dense_grain = 16;
+        set_tuned(p);
+        set_par_threads(4);
+    }
+    ~ewise_par() { set_tuned(old); set_par_threads(threads); }
+};
+
+TEST(elementwise, map_and_zip_vectors) {
+    ewise_par par;
+    owned_vec<double> x(1000), y(1000), z(1000);
+    for (size_t i = 0; i < 1000; i++) x[i] = double(i);
+    map(x.as_const(), y.as_ref(), [](double v) { return 2 * v; });
+    zip_with(x.as_const(), y.as_const(), z.as_ref(), [](double a, double b) { return a + b; });
+    for (size_t i = 0; i < 1000; i++) { ASSERT_EQ(y[i], 2.0 * i); ASSERT_EQ(z[i], 3.0 * i); }
+
+    vec<double, true> odd(x.ptr() + 1, 500, 2);
+    owned_vec<double> w(500);
+    map(odd.as_const(), w.as_ref(), [](double v) { return v * v; });
+    for (size_t i = 0; i < 500; i++) ASSERT_EQ(w[i], double((2 * i) + 1) * double((2 * i) + 1));
+
+    ASSERT_THROW(map(x.as_const(), w.as_ref(), [](double v) { return v; }), vec_len_mismatch);
+}
+
+TEST(elementwise, reductions_of_vectors) {
+    ewise_par par;
+    owned_vec<long> x(1001);
+    for (size_t i = 0; i < 1001; i++) x[i] = long(i);
+    ASSERT_EQ(reduce(x.as_const(), 0L, std::plus<>()), 1001L * 500);
+    ASSERT_EQ(reduce(x.as_const(), 7L, [](long a, long b) { return std::max(a, b); }), 1000);
+    ASSERT_EQ(transform_reduce(x.as_const(), 0L, std::plus<>(), [](long v) { return v % 2; }), 500);
+    ASSERT_EQ(transform_reduce(x.as_const(), x.as_const(), 0L, std::plus<>(),
+                               [](long a, long b) { return a * b; }),
+              1000L * 1001 * 2001 / 6);
+    vec<long, true> evens(x.ptr(), 501, 2);
+    ASSERT_EQ(reduce(evens.as_const(), 0L, std::plus<>()), 500L * 501);
+    ASSERT_EQ(reduce(owned_vec<long>(0).as_const(), 5L, std::plus<>()), 5);
+}
+
+TEST(elementwise, reductions_do_not_depend_on_scheduling) {
+    ewise_par par;
+    owned_vec<float> x(100000);
+    for (size_t i = 0; i < x.len(); i++) x[i] = 1.0f / float(i + 1);
+    float first = reduce(x.as_const(), 0.0f, std::plus<>());
+    for (int r = 0; r < 20; r++) ASSERT_EQ(reduce(x.as_const(), 0.0f, std::plus<>()), first);
+}
+
+TEST(elementwise, reproducible_reductions_do_not_depend_on_thread_count) {
+    ewise_par par;
+    set_par_reproducible(true);
+    owned_vec<float> x(100003);
+    for (size_t i = 0; i < x.len(); i++) x[i] = 1.0f / float(i + 1);
+    auto row = numbered<mat_maj::row>(301, 257);
+    auto col = numbered<mat_maj::col>(301, 257);
+    auto mul = [](double a, double b) { return a * 0.1 * b; };
+    set_par_threads(1);
+    float  first = reduce(x.as_const(), 0.0f, std::plus<>());
+    double mixed = transform_reduce(row.as_const(), col.as_const(), 0.0, std::plus<>(), mul);
+    for (size_t t : {2, 3, 4, 7, 16}) {
+        set_par_threads(t);
+        ASSERT_EQ(reduce(x.as_const(), 0.0f, std::plus<>()), first);
+        ASSERT_EQ(transform_reduce(row.as_const(), col.as_const(), 0.0, std::plus<>(), mul), mixed);
+    }
+    set_par_reproducible(false);
+}
+
+template<mat_maj am, mat_maj bm, mat_maj cm>
+static void check_mats() {
+    auto a = numbered<am>(37, 23), b = numbered<bm>(37, 23);
+    owned_mat<double, cm> c(37, 23);
+    zip_with(a.as_const(), b.as_const(), c.as_ref(), [](double x, double y) { return x - 2 * y; });
+    for (size_t i = 0; i < 37; i++) for (size_t j = 0; j < 23; j++)
+        ASSERT_EQ(c[i][j], a[i][j] - 2 * b[i][j]);
+    map(a.as_const(), c.as_ref(), [](double x) { return x + 1; });
+    for (size_t i = 0; i < 37; i++) for (size_t j = 0; j < 23; j++)
+        ASSERT_EQ(c[i][j], a[i][j] + 1);
+
+    double dot = 0;
+    for (size_t i = 0; i < 37; i++) for (size_t j = 0; j < 23; j++) dot += a[i][j] * c[i][j];
+    ASSERT_EQ(transform_reduce(a.as_const(), c.as_const(), 0.0, std::plus<>(),
+                               [](double x, double y) { return x * y; }), dot);
+}
+
+TEST(elementwise, matrices_in_any_storage_order) {
+    ewise_par par;
+    check_mats<mat_maj::row, mat_maj::row, mat_maj::row>();
+    check_mats<mat_maj::col, mat_maj::col, mat_maj::col>();
+    check_mats<mat_maj::row, mat_maj::col, mat_maj::row>();
+    check_mats<mat_maj::col, mat_maj::row, mat_maj::row>();
+    check_mats<mat_maj::row, mat_maj::row, mat_maj::col>();
+
+    auto a = numbered<mat_maj::col>(5, 4);
+    ASSERT_EQ(reduce(a.as_const(), 0.0, [](double x, double y) { return std::min(x, y); }), -5);
+    owned_row_mat<double> bad(4, 5);
+    ASSERT_THROW(map(a.as_const(), bad.as_ref(), [](double x) { return x; }), mat_size_mismatch);
+}
+// NOLINTEND
@@ -0,0 +1,57 @@
+#include "blas1.hxx"
+#include "fixed.hxx"
+#include "gemv.hxx"
+#include <gtest.h>
+
+// NOLINTBEGIN
+constexpr fixed_mat<int, 2, 3> lhs() {
+    fixed_mat<int, 2, 3> m;
+    for (size_t r = 0; r < 2; r++) for (size_t c = 0; c < 3; c++) m(r, c) = int(r * 3 + c);
+    return m;
+}
+
+TEST(fixed, arithmetic_is_constexpr) {
+    constexpr auto a = lhs();
+    constexpr auto p = a * a.transposed();
+    static_assert(p.get<0, 0>() == 5 && p.get<0, 1>() == 14 && p.get<1, 1>() == 50);
+    constexpr auto i = fixed_col_mat<int, 3, 3>::identity();
+    static_assert(a * i == a);
+    constexpr fixed_vec<int, 3> v {{1, 2, 3}};
+    static_assert((a * v).get<1>() == 26);
+    static_assert(v * v == 14);
+    static_assert((v + v - v * 2) == fixed_vec<int, 3> {});
+}
+
+template<typename A, typename B> concept addable = requires(A a, B b) { a + b; };
+template<typename A, typename B> concept multipliable = requires(A a, B b) { a * b; };
+
+TEST(fixed, shape_mismatches_do_not_compile) {
+    static_assert( addable<fixed_mat<int, 2, 3>, fixed_col_mat<int, 2, 3>>);
+    static_assert(!addable<fixed_mat<int, 2, 3>, fixed_mat<int, 3, 2>>);
+    static_assert( multipliable<fixed_mat<int, 2, 3>, fixed_mat<int, 3, 5>>);
+    static_assert(!multipliable<fixed_mat<int, 2, 3>, fixed_mat<int, 2, 3>>);
+    static_assert(!multipliable<fixed_mat<int, 2, 3>, fixed_vec<int, 2>>);
+    static_assert(!addable<fixed_vec<int, 2>, fixed_vec<int, 3>>);
+}
+
+TEST(fixed, runtime_indices_are_checked) {
+    fixed_mat<int, 2, 2> m;
+    fixed_vec<int, 2> v;
+    ASSERT_THROW(m(2, 0) = 1, mat_out_of_bounds);
+    ASSERT_THROW(v[2] = 1, vec_out_of_bounds);
+}
+
+TEST(fixed, views_plug_into_library_algorithms) {
+    fixed_col_mat<double, 3, 2> a;
+    a(0, 0) = 1; a(1, 1) = 2; a(2, 0) = 3;
+    fixed_vec<double, 2> x {{4, 5}};
+    fixed_vec<double, 3> y;
+    gemv(1.0, a.as_mat().as_const(), x.as_vec(), 0.0, y.as_vec());
+    ASSERT_EQ(y, a * x);
+    ASSERT_DOUBLE_EQ(nrm2(a.col(0).as_const()), std::sqrt(10.0));
+    a.row(2)[1] = 7;
+    ASSERT_EQ(a(2, 1), 7);
+    mat<double const, mat_maj::col> view = a;
+    ASSERT_EQ(view.n_rows(), 3);
+}
+// NOLINTEND
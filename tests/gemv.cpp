@@ -0,0 +1,65 @@
+#include "gemv.hxx"
+#include "owned_mat.hxx"
+#include <gtest.h>
+
+// NOLINTBEGIN
+template<mat_maj maj>
+static owned_mat<double, maj> numbered(size_t rows, size_t cols) {
+    owned_mat<double, maj> m(rows, cols);
+    for (size_t i = 0; i < rows; i++) for (size_t j = 0; j < cols; j++)
+        m[i][j] = double((i * 7 + j * 3) % 11) - 5;
+    return m;
+}
+
+template<mat_maj maj>
+static void check_gemv(size_t rows, size_t cols) {
+    auto a = numbered<maj>(rows, cols);
+    owned_vec<double> x(cols), y(rows), xt(rows), yt(cols);
+    for (size_t j = 0; j < cols; j++) x[j] = (j % 5) - 2.0;
+    for (size_t i = 0; i < rows; i++) { y[i] = 1; xt[i] = (i % 3) - 1.0; }
+    for (size_t j = 0; j < cols; j++) yt[j] = 2;
+    gemv(2.0, a.as_const(), x.as_const(), 3.0, y.as_ref());
+    gemv_t(1.0, a.as_const(), xt.as_const(), -1.0, yt.as_ref());
+    for (size_t i = 0; i < rows; i++) {
+        double s = 0;
+        for (size_t j = 0; j < cols; j++) s += a[i][j] * x[j];
+        ASSERT_EQ(y[i], (2 * s) + 3);
+    }
+    for (size_t j = 0; j < cols; j++) {
+        double s = 0;
+        for (size_t i = 0; i < rows; i++) s += a[i][j] * xt[i];
+        ASSERT_EQ(yt[j], s - 2);
+    }
+}
+
+TEST(gemv, row_major) { check_gemv<mat_maj::row>(37, 23); }
+TEST(gemv, col_major) { check_gemv<mat_maj::col>(37, 23); }
+TEST(gemv, large_blocked_and_parallel) {
+    check_gemv<mat_maj::row>(3000, 2500);
+    check_gemv<mat_maj::col>(2500, 3000);
+}
+
+TEST(gemv, strided_operands) {
+    auto a = numbered<mat_maj::col>(6, 4);
+    auto xs = numbered<mat_maj::row>(4, 3);
+    owned_row_mat<double> ys(6, 2);
+    gemv(1.0, a.as_const(), xs.col(1).as_const(), 0.0, ys.col(0));
+    for (size_t i = 0; i < 6; i++) {
+        double s = 0;
+        for (size_t j = 0; j < 4; j++) s += a[i][j] * xs[j][1];
+        ASSERT_EQ(ys[i][0], s);
+        ASSERT_EQ(ys[i][1], 0);
+    }
+}
+
+TEST(gemv, operator_and_size_checks) {
+    auto a = numbered<mat_maj::row>(3, 2);
+    owned_vec<double> x(2);
+    x[0] = 1; x[1] = 2;
+    auto y = a.as_const() * x.as_const();
+    for (size_t i = 0; i < 3; i++) ASSERT_EQ(y[i], a[i][0] + 2 * a[i][1]);
+    owned_vec<double> bad(3);
+    ASSERT_THROW((void)(a.as_const() * bad.as_const()), vec_len_mismatch);
+    ASSERT_THROW(gemv(1.0, a.as_const(), x.as_const(), 0.0, x.as_ref()), vec_len_mismatch);
+}
+// NOLINTEND
@@ -0,0 +1,126 @@
+#include "int_arith.hxx"
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include <gtest.h>
+#include <limits>
+
+// NOLINTBEGIN
+template<typename T, int_op op>
+static void check_against_builtins(T a, T b) {
+    using lim = std::numeric_limits<T>;
+    owned_vec<T> x(1, false), y(1, false), z(1, false);
+    x[0] = a; y[0] = b;
+    T want;
+    bool ok = op == int_op::add ? !__builtin_add_overflow(a, b, &want)
+            : op == int_op::sub ? !__builtin_sub_overflow(a, b, &want)
+            :                     !__builtin_mul_overflow(a, b, &want);
+    int_arith<int_mode::wrap, op>(x.as_const(), y.as_const(), z.as_ref());
+    ASSERT_EQ(z[0], want);
+    int_arith<int_mode::saturate, op>(x.as_const(), y.as_const(), z.as_ref());
+    if (ok) ASSERT_EQ(z[0], want);
+    else {
+        bool neg = op == int_op::mul ? (a < 0) != (b < 0) : op == int_op::add ? a < 0 : a < b;
+        ASSERT_EQ(z[0], neg ? lim::min() : lim::max());
+    }
+    if (ok) int_arith<int_mode::check, op>(x.as_const(), y.as_const(), z.as_ref());
+    else    ASSERT_THROW((int_arith<int_mode::check, op>(x.as_const(), y.as_const(), z.as_ref())),
+                         int_overflow);
+}
+
+template<typename T>
+static void check_type() {
+    using lim = std::numeric_limits<T>;
+    T vals[] = {lim::min(), T(lim::min() + 1), T(lim::min() / 2), T(-1), T(0), T(1), T(2), T(3),
+                T(lim::max() / 2), T(lim::max() - 1), lim::max()};
+    for (T a : vals) for (T b : vals) {
+        check_against_builtins<T, int_op::add>(a, b);
+        check_against_builtins<T, int_op::sub>(a, b);
+        check_against_builtins<T, int_op::mul>(a, b);
+    }
+}
+
+TEST(int_arith, modes_agree_with_builtins) {
+    check_type<i8>();
+    check_type<u8>();
+    check_type<i16>();
+    check_type<u16>();
+    check_type<i32>();
+    check_type<u32>();
+    check_type<i64>();
+    check_type<u64>();
+}
+
+TEST(int_arith, checked_vectors_report_the_element) {
+    owned_vec<i16> x(5000), y(5000), z(5000);
+    for (size_t i = 0; i < 5000; i++) { x[i] = i16(i % 300); y[i] = 100; }
+    int_mul<int_mode::check>(x.as_const(), y.as_const(), z.as_ref());
+    ASSERT_EQ(z[4999], 4999 % 300 * 100);
+    x[3333] = 400;
+    try {
+        int_mul<int_mode::check>(x.as_const(), y.as_const(), z.as_ref());
+        FAIL();
+    } catch (int_overflow const& e) {
+        ASSERT_STREQ(e.what(), "integer overflow in element 3333");
+    }
+    vec<i16, true> odds(x.ptr() + 1, 2499, 2);
+    owned_vec<i16> w(2499);
+    int_add<int_mode::saturate>(odds.as_const(), odds.as_const(), w.as_ref());
+    ASSERT_EQ(w[1666], 800);
+    ASSERT_THROW(int_add(x.as_const(), w.as_const(), z.as_ref()), vec_len_mismatch);
+}
+
+TEST(int_arith, checked_reports_the_lowest_overflow_in_parallel) {
+    size_t old = par_threads();
+    tune_params p = tuned(), small = p;
+    small.dense_grain = 1000;
+    set_par_threads(4);
+    set_tuned(small);
+    owned_vec<i32> x(8000), y(8000), z(8000);
+    for (size_t i = 0; i < 8000; i++) { x[i] = 1; y[i] = 2; }
+    x[7500] = x[5200] = x[2100] = std::numeric_limits<i32>::max();
+    owned_col_mat<i32> a(40, 50), c(40, 50);
+    owned_row_mat<i32> b(40, 50);
+    a[30][45] = a[20][1] = b[39][3] = std::numeric_limits<i32>::max();
+    b[20][1] = b[30][45] = b[39][3] = 1;
+    for (int rep = 0; rep < 20; rep++) {
+        try {
+            int_add<int_mode::check>(x.as_const(), y.as_const(), z.as_ref());
+            FAIL();
+        } catch (int_overflow const& e) {
+            ASSERT_STREQ(e.what(), "integer overflow in element 2100");
+        }
+        try {
+            int_add<int_mode::check>(a.as_const(), b.as_const(), c.as_ref());
+            FAIL();
+        } catch (int_overflow const& e) {
+            ASSERT_STREQ(e.what(), "integer overflow in element 60"); // column 1, row 20
+        }
+    }
+    set_tuned(p);
+    set_par_threads(old);
+}
+
+template<typename V>
+concept int_addable = requires(V v) { int_add(v.as_const(), v.as_const(), v.as_ref()); };
+static_assert(int_addable<owned_vec<int>>);
+static_assert(!int_addable<owned_vec<float>>);
+static_assert(!int_addable<owned_row_mat<double>>);
+
+TEST(int_arith, matrices_in_any_storage_order) {
+    owned_row_mat<u8> a(20, 30);
+    owned_col_mat<u8> b(20, 30);
+    owned_row_mat<u8> c(20, 30);
+    for (size_t i = 0; i < 20; i++) for (size_t j = 0; j < 30; j++) {
+        a[i][j] = u8(i * 10);
+        b[i][j] = u8(j * 5);
+    }
+    int_add<int_mode::saturate>(a.as_const(), b.as_const(), c.as_ref());
+    for (size_t i = 0; i < 20; i++) for (size_t j = 0; j < 30; j++)
+        ASSERT_EQ(c[i][j], std::min<size_t>(255, (i * 10) + (j * 5)));
+    int_sub<int_mode::saturate>(a.as_const(), a.as_const(), c.as_ref());
+    ASSERT_EQ(c[19][29], 0);
+    ASSERT_THROW(int_add<int_mode::check>(a.as_const(), b.as_const(), c.as_ref()), int_overflow);
+    owned_row_mat<u8> d(30, 20);
+    ASSERT_THROW(int_add(a.as_const(), b.as_const(), d.as_ref()), mat_size_mismatch);
+}
+// NOLINTEND
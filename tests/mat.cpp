@@ -116,4 +116,17 @@ TEST(mat, subtract_with_different_size_fails) {
     owned_col_mat<int> m1(3, 4), m2(5, 6);
     ASSERT_ANY_THROW(m2 -= m1);
 }
+
+TEST(mat, copy_across_storage_orders) {
+    owned_row_mat<int> r(3, 4);
+    for (size_t i = 0; i < 3; i++) for (size_t j = 0; j < 4; j++) r[i][j] = (i * 4) + j;
+    owned_col_mat<int> c(3, 4);
+    c.copy_from(r);
+    for (size_t i = 0; i < 3; i++) for (size_t j = 0; j < 4; j++) ASSERT_EQ(c[i][j], r[i][j]);
+    ASSERT_EQ(c, r);
+    c += r;
+    ASSERT_EQ(c[2][3], 22);
+    owned_col_mat<int> big(4, 4);
+    ASSERT_THROW(big.copy_from(r), mat_size_mismatch);
+}
 // NOLINTEND
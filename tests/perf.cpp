@@ -0,0 +1,125 @@
+#include "axis.hxx"
+#include "int_arith.hxx"
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include "par.hxx"
+#include "perf.hxx"
+#include "sell.hxx"
+#include "stride_vec.hxx"
+#include <gtest.h>
+#include <sstream>
+
+// NOLINTBEGIN
+TEST(perf, scope_accumulates_per_site) {
+    perf_registry::get().reset();
+    for (int i = 0; i < 3; i++) { perf_scope s("test.site", 100); }
+    { perf_scope s("test.other", 7); }
+    auto st = perf_registry::get().at("test.site");
+    ASSERT_EQ(st.calls, 3);
+    ASSERT_EQ(st.bytes, 300);
+    ASSERT_EQ(perf_registry::get().snapshot().size(), 2);
+    ASSERT_EQ(perf_registry::get().at("missing").calls, 0);
+}
+
+TEST(perf, scope_takes_work_known_at_the_end) {
+    perf_registry::get().reset();
+    { perf_scope s("test.add", 10, 1); s.add(5, 2); }
+    auto st = perf_registry::get().at("test.add");
+    ASSERT_EQ(st.bytes, 15);
+    ASSERT_EQ(st.flops, 3);
+}
+
+TEST(perf, counters_advance_when_available) {
+    perf_registry::get().reset();
+    {
+        perf_scope s("test.loop", 0);
+        volatile double x = 0;
+        for (int i = 0; i < 100000; i++) x = x + 1;
+    }
+    auto st = perf_registry::get().at("test.loop");
+    if (!perf_counters_available()) return; // perf_event_open is not permitted here
+    ASSERT_GT(st.cycles, 0);
+    ASSERT_GT(st.instructions, 100000);
+}
+
+TEST(perf, scope_counts_par_invoke_workers) {
+    auto spin = [] { volatile double x = 0; for (int i = 0; i < 100000; i++) x = x + 1; };
+    perf_registry::get().reset();
+    { perf_scope s("test.serial", 0); for (int p = 0; p < 4; p++) spin(); }
+    { perf_scope s("test.par", 0); par_invoke(4, [&](size_t) { spin(); }); }
+    ASSERT_EQ(perf_scope::current(), nullptr);
+    auto serial = perf_registry::get().at("test.serial"), par = perf_registry::get().at("test.par");
+    ASSERT_EQ(par.calls, 1);
+    if (!perf_counters_available()) return; // perf_event_open is not permitted here
+    ASSERT_GT(par.instructions, serial.instructions * 9 / 10);
+}
+
+#if defined(MATRIX_PERF_COUNTERS)
+TEST(perf, copies_and_element_wise_ops_are_scoped) {
+    owned_row_mat<double> a(4, 5), b(4, 5);
+    owned_col_mat<double> t(4, 5);
+    owned_vec<double> x(6), y(6);
+    perf_registry::get().reset();
+    b = a;
+    a += b;
+    a -= b;
+    t.copy_from(a);
+    (void)(a == b);
+    y = x;
+    x += y;
+    x -= y;
+    x *= 2.0;
+    (void)(x * y);
+    (void)(x == y);
+    auto snap = perf_registry::get().snapshot();
+    for (char const* site : {"mat.assign", "mat.add_assign", "mat.sub_assign", "mat.copy_from",
+                             "mat.eq", "vec.assign", "vec.add_assign", "vec.sub_assign",
+                             "vec.mul_scalar", "vec.dot", "vec.eq"})
+        ASSERT_EQ(snap[site].calls, 1) << site;
+    ASSERT_EQ(snap["mat.add_assign"].flops, 20);
+    ASSERT_EQ(snap["vec.assign"].bytes, 2 * 6 * sizeof(double));
+}
+
+TEST(perf, kernel_entry_points_are_scoped) {
+    owned_vec<double> x(8), y(8);
+    owned_vec<int> i(8), j(8);
+    owned_row_mat<double> a(3, 4);
+    auto s = sell_mat<double>::from_entries(8, 8, {{0, 0, 1.0}, {3, 5, 2.0}});
+    stride_vec<double, 2> xs(x.ptr(), 4), ys(y.ptr(), 4);
+    perf_registry::get().reset();
+    axpy(2.0, x.as_const(), y.as_ref());
+    axpby(2.0, x.as_const(), 3.0, y.as_ref());
+    scal(2.0, x.as_ref());
+    (void)dot(x.as_const(), y.as_const());
+    (void)asum(x.as_const());
+    (void)nrm2(x.as_const());
+    map(x.as_const(), y.as_ref(), [](double v) { return v + 1; });
+    zip_with(x.as_const(), y.as_const(), y.as_ref(), [](double u, double v) { return u * v; });
+    (void)transform_reduce(x.as_const(), 0.0, std::plus<>(), [](double v) { return v; });
+    axpy(2.0, xs.as_const(), ys);
+    ys += xs;
+    int_add<int_mode::check>(i.as_const(), j.as_const(), j.as_ref());
+    (void)row_argmax(a.as_const());
+    (void)col_argmax(a.as_const());
+    (void)(s * x.as_const());
+    auto snap = perf_registry::get().snapshot();
+    for (char const* site : {"axpby", "scal", "dot", "asum", "nrm2", "map", "zip_with",
+                             "transform_reduce", "stride_vec.add_assign", "int_arith",
+                             "row_argmax", "col_argmax", "sell.spmv"})
+        ASSERT_EQ(snap[site].calls, 1) << site;
+    ASSERT_EQ(snap["axpy"].calls, 2);
+    ASSERT_EQ(snap["axpy"].flops, (2 * 8) + (2 * 4));
+    ASSERT_EQ(snap["int_arith"].bytes, 3 * 8 * sizeof(int));
+    ASSERT_EQ(snap["sell.spmv"].flops, 4);
+}
+#endif
+
+TEST(perf, json_dump_lists_sites) {
+    perf_registry::get().reset();
+    { perf_scope s("test.json", 42); }
+    std::stringstream o;
+    perf_registry::get().dump_json(o);
+    ASSERT_NE(o.str().find("\"test.json\": {\"calls\": 1"), std::string::npos);
+    ASSERT_NE(o.str().find("\"bytes\": 42"), std::string::npos);
+}
+// NOLINTEND
@@ -0,0 +1,79 @@
+#include "qr.hxx"
+#include <gtest.h>
+
+// NOLINTBEGIN
+static owned_col_mat<double> tall(size_t rows, size_t cols) {
+    owned_col_mat<double> a(rows, cols);
+    for (size_t i = 0; i < rows; i++) for (size_t j = 0; j < cols; j++)
+        a[i][j] = ((i * 7 + j * 13) % 17) / 4.0 + (i == j ? 3.0 : 0.0);
+    return a;
+}
+
+TEST(qr, wide_matrix_fails) { ASSERT_THROW(qr_fact<double> f(tall(3, 5)), qr_too_wide); }
+
+TEST(qr, q_times_r_is_original) {
+    auto a = tall(40, 9);
+    qr_fact<double> f(a, 4);
+    owned_col_mat<double> qr(40, 9);
+    auto r = f.r();
+    for (size_t j = 0; j < 9; j++) for (size_t i = 0; i <= j; i++) qr[i][j] = r[i][j];
+    f.apply_q(qr);
+    for (size_t i = 0; i < 40; i++) for (size_t j = 0; j < 9; j++)
+        ASSERT_NEAR(qr[i][j], a[i][j], 1e-10);
+}
+
+TEST(qr, qt_undoes_q) {
+    qr_fact<double> f(tall(25, 6), 4);
+    auto b = tall(25, 3), c = b;
+    f.apply_q(c);
+    f.apply_qt(c);
+    for (size_t i = 0; i < 25; i++) for (size_t j = 0; j < 3; j++)
+        ASSERT_NEAR(c[i][j], b[i][j], 1e-10);
+}
+
+TEST(qr, solves_consistent_system) {
+    auto a = tall(30, 5);
+    owned_vec<double> x(5), b(30);
+    for (size_t j = 0; j < 5; j++) x[j] = j + 1.0;
+    for (size_t i = 0; i < 30; i++) for (size_t j = 0; j < 5; j++) b[i] += a[i][j] * x[j];
+    auto got = qr_fact<double>(a, 2).solve(b);
+    for (size_t j = 0; j < 5; j++) ASSERT_NEAR(got[j], x[j], 1e-10);
+}
+
+TEST(qr, rank_deficient_solve_fails) {
+    owned_col_mat<double> a(4, 2);
+    a[0][0] = a[1][0] = 1;
+    owned_vec<double> b(4);
+    ASSERT_THROW((void)qr_fact<double>(a).solve(b), qr_rank_deficient);
+}
+
+TEST(tsqr, matches_blocked_qr) {
+    auto a = tall(203, 7);
+    owned_vec<double> b(203);
+    for (size_t i = 0; i < 203; i++) b[i] = (i % 5) - 2.0;
+    auto want = qr_fact<double>(a).solve(b);
+    for (size_t blocks : {1, 2, 5, 8}) {
+        tsqr_fact<double> f(a, blocks, 3);
+        ASSERT_EQ(f.n_blocks(), blocks);
+        auto got = f.solve(b);
+        for (size_t j = 0; j < 7; j++) ASSERT_NEAR(got[j], want[j], 1e-9);
+    }
+}
+
+TEST(tsqr, r_matches_blocked_qr_up_to_sign) {
+    auto a = tall(64, 4);
+    auto r1 = qr_fact<double>(a).r(), r2 = tsqr_fact<double>(a, 4).r();
+    for (size_t i = 0; i < 4; i++) for (size_t j = i; j < 4; j++)
+        ASSERT_NEAR(std::abs(r1[i][j]), std::abs(r2[i][j]), 1e-10);
+}
+
+TEST(tsqr, lstsq_of_strided_rhs) {
+    auto a = tall(120, 3);
+    owned_row_mat<double> bs(120, 2);
+    for (size_t i = 0; i < 120; i++) bs[i][1] = a[i][0] + 2 * a[i][2];
+    auto x = lstsq(a.as_const(), bs.col(1));
+    ASSERT_NEAR(x[0], 1, 1e-10);
+    ASSERT_NEAR(x[1], 0, 1e-10);
+    ASSERT_NEAR(x[2], 2, 1e-10);
+}
+// NOLINTEND
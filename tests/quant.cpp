@@ -0,0 +1,135 @@
+#include "quant.hxx"
+#include <gtest.h>
+#include <cmath>
+#include <limits>
+
+// NOLINTBEGIN
+template<mat_maj maj>
+static owned_mat<f32, maj> wave(size_t m, size_t n, f32 amp) {
+    owned_mat<f32, maj> a(m, n);
+    for (size_t i = 0; i < m; i++) for (size_t j = 0; j < n; j++)
+        a[i][j] = amp * std::sin(f32((i * 7) + (j * 3) + 1)) * f32(1 + (i % 3));
+    return a;
+}
+
+TEST(quant, round_trip) {
+    auto a = wave<mat_maj::row>(13, 21, 2.5f);
+    auto qr = quantize<i8, quant_axis::row>(a.as_const());
+    auto qc = quantize<i8, quant_axis::col>(a.as_const());
+    auto dr = dequantize(qr), dc = dequantize(qc);
+    for (size_t i = 0; i < 13; i++) {
+        f32 big = 0;
+        for (size_t j = 0; j < 21; j++) big = std::max(big, std::abs(a[i][j]));
+        ASSERT_FLOAT_EQ(qr.scale[i], big / 127);
+        for (size_t j = 0; j < 21; j++) {
+            ASSERT_LE(std::abs(dr[i][j] - a[i][j]), qr.scale[i] / 2 * 1.0001f);
+            ASSERT_LE(std::abs(dc[i][j] - a[i][j]), qc.scale[j] / 2 * 1.0001f);
+            ASSERT_LE(std::abs(int(qr.q[i][j])), 127);
+        }
+    }
+    // Every row reaches the end of the range, and zero rows quantize to zeros.
+    for (size_t i = 0; i < 13; i++) {
+        int top = 0;
+        for (size_t j = 0; j < 21; j++) top = std::max(top, std::abs(int(qr.q[i][j])));
+        ASSERT_EQ(top, 127);
+    }
+    owned_mat<f32, mat_maj::col> z(3, 4);
+    auto qz = quantize<i16, quant_axis::row>(z.as_const());
+    for (size_t i = 0; i < 3; i++) {
+        ASSERT_EQ(qz.scale[i], 0.0f);
+        for (size_t j = 0; j < 4; j++) ASSERT_EQ(qz.q[i][j], 0);
+    }
+}
+
+template<typename Q, mat_maj am, mat_maj bm, mat_maj cm>
+static void check_qgemm(size_t m, size_t k, size_t n) {
+    auto a = quantize<Q, quant_axis::row>(wave<am>(m, k, 1.0f).as_const());
+    auto b = quantize<Q, quant_axis::col>(wave<bm>(k, n, 3.0f).as_const());
+    owned_mat<f32, cm> c(m, n);
+    qgemm(a.q.as_const(), a.scale.as_const(), b.q.as_const(), b.scale.as_const(), c.as_ref());
+    for (size_t i = 0; i < m; i++) for (size_t j = 0; j < n; j++) {
+        i64 s = 0;
+        for (size_t l = 0; l < k; l++) s += i64(a.q[i][l]) * i64(b.q[l][j]);
+        ASSERT_FLOAT_EQ(c[i][j], a.scale[i] * b.scale[j] * f32(s));
+    }
+}
+
+TEST(quant, qgemm_matches_integer_products) {
+    check_qgemm<i8,  mat_maj::row, mat_maj::col, mat_maj::row>(9, 37, 11);
+    check_qgemm<i8,  mat_maj::col, mat_maj::row, mat_maj::col>(9, 37, 11);
+    check_qgemm<i8,  mat_maj::row, mat_maj::row, mat_maj::row>(1, 300, 5);
+    check_qgemm<i16, mat_maj::row, mat_maj::col, mat_maj::row>(17, 64, 3);
+    check_qgemm<i16, mat_maj::col, mat_maj::col, mat_maj::row>(4, 9, 1);
+}
+
+TEST(quant, qgemm_approximates_f32_product) {
+    size_t m = 24, k = 200, n = 7;
+    auto a = wave<mat_maj::row>(m, k, 0.5f);
+    auto b = wave<mat_maj::col>(k, n, 4.0f);
+    auto c = qgemm(quantize<i8, quant_axis::row>(a.as_const()),
+                   quantize<i8, quant_axis::col>(b.as_const()));
+    for (size_t i = 0; i < m; i++) for (size_t j = 0; j < n; j++) {
+        f32 want = 0, mag = 0;
+        for (size_t l = 0; l < k; l++) {
+            want += a[i][l] * b[l][j];
+            mag  += std::abs(a[i][l] * b[l][j]);
+        }
+        ASSERT_NEAR(c[i][j], want, 0.02f * mag);
+    }
+}
+
+TEST(quant, qgemm_checks_sizes) {
+    owned_mat<i8, mat_maj::row> a(3, 4), b(5, 2);
+    owned_mat<f32, mat_maj::row> c(3, 2);
+    owned_vec<f32> sa(3), sb(2);
+    ASSERT_THROW(qgemm(a.as_const(), sa.as_const(), b.as_const(), sb.as_const(), c.as_ref()),
+                 mat_size_mismatch);
+    owned_mat<i8, mat_maj::row> b4(4, 2);
+    owned_vec<f32> s4(4);
+    ASSERT_THROW(qgemm(a.as_const(), s4.as_const(), b4.as_const(), sb.as_const(), c.as_ref()),
+                 vec_len_mismatch);
+}
+
+TEST(quant, non_finite_elements_are_rejected) {
+    auto a = wave<mat_maj::row>(4, 5, 1.0f);
+    a[2][3] = std::numeric_limits<f32>::quiet_NaN();
+    a[3][1] = std::numeric_limits<f32>::infinity();
+    try {
+        (void)quantize<i8, quant_axis::row>(a.as_const());
+        FAIL();
+    } catch (quant_non_finite const& e) {
+        ASSERT_NE(std::string(e.what()).find("(2, 3)"), std::string::npos);
+    }
+    auto c = wave<mat_maj::col>(4, 5, 1.0f);
+    c[3][0] = -std::numeric_limits<f32>::infinity();
+    c[0][1] = std::numeric_limits<f32>::quiet_NaN();
+    try {
+        (void)quantize<i16, quant_axis::row>(c.as_const());
+        FAIL();
+    } catch (quant_non_finite const& e) {
+        ASSERT_NE(std::string(e.what()).find("(3, 0)"), std::string::npos);
+    }
+    owned_mat<double, mat_maj::row> d(2, 2);
+    d[1][0] = 1e300; // finite, but not as an f32
+    ASSERT_THROW((void)(quantize<i8, quant_axis::col>(d.as_const())), quant_non_finite);
+}
+
+template<typename A>
+concept qgemm_accepts = requires(A a, owned_vec<f32> s, owned_mat<f32, mat_maj::row> c) {
+    qgemm(a.as_const(), s.as_const(), a.as_const(), s.as_const(), c.as_ref());
+};
+static_assert(qgemm_accepts<owned_mat<i8, mat_maj::row>>);
+static_assert(!qgemm_accepts<owned_mat<f32, mat_maj::row>>);
+
+TEST(quant, qgemm_in_parallel) {
+    size_t old = par_threads();
+    set_par_threads(4);
+    tune_params p = tuned();
+    tune_params small = p;
+    small.dense_grain = 64;
+    set_tuned(small);
+    check_qgemm<i8, mat_maj::row, mat_maj::col, mat_maj::row>(33, 20, 9);
+    set_tuned(p);
+    set_par_threads(old);
+}
+// NOLINTEND
@@ -0,0 +1,32 @@
+#include "roofline.hxx"
+#include <gtest.h>
+#include <sstream>
+
+// NOLINTBEGIN
+TEST(roofline, roofs_meet_at_the_ridge) {
+    roofline_machine m {.gbps = 20, .gflops = 100};
+    ASSERT_DOUBLE_EQ(m.ridge(), 5);
+    ASSERT_DOUBLE_EQ(m.attainable(1), 20);
+    ASSERT_DOUBLE_EQ(m.attainable(50), 100);
+}
+
+TEST(roofline, probes_measure_something) {
+    ASSERT_GT(stream_triad_gbps(1 << 16, 2), 0);
+    ASSERT_GT(peak_gflops(1 << 10), 0);
+}
+
+TEST(roofline, report_classifies_sites) {
+    roofline_machine m {.gbps = 10, .gflops = 100};
+    std::map<std::string, perf_stats> sites;
+    sites["axpy"] = {.calls = 1, .bytes = 2400, .flops = 200, .ns = 400};
+    sites["gemm"] = {.calls = 2, .bytes = 100, .flops = 10000, .ns = 200};
+    sites["copy"] = {.calls = 3, .bytes = 100, .ns = 10};
+    std::stringstream o;
+    roofline_report(o, m, sites);
+    auto s = o.str();
+    auto line = s.substr(s.find("axpy"), s.find('\n', s.find("axpy")) - s.find("axpy"));
+    ASSERT_NE(line.find("0.08      6.00      0.50      0.83   60.00  memory"), std::string::npos);
+    ASSERT_NE(s.find("compute"), std::string::npos);
+    ASSERT_NE(s.find("  -\n"), std::string::npos);
+}
+// NOLINTEND
@@ -0,0 +1,71 @@
+#include "sell.hxx"
+#include <gtest.h>
+#include <cmath>
+#include <limits>
+
+// NOLINTBEGIN
+// Row lengths follow a power law: row i has about n / (i + 1) elements.
+static std::vector<coo_entry<double>> power_law(size_t n) {
+    std::vector<coo_entry<double>> es;
+    for (size_t i = 0; i < n; i++) {
+        size_t len = n / (((i * 37) % n) + 1);
+        for (size_t k = 0; k < len; k++) es.push_back({i, (i + (k * 13)) % n, 1.0 + (k % 3)});
+    }
+    return es;
+}
+
+TEST(sell, keeps_all_elements) {
+    auto a = sell_mat<double>::from_entries(100, 100, power_law(100));
+    auto b = csr_mat<double>::from_entries(100, 100, power_law(100));
+    ASSERT_EQ(a.nnz(), b.nnz());
+    ASSERT_GE(a.n_stored(), a.nnz());
+    ASSERT_EQ(a.n_stored() % a.chunk_height, 0);
+}
+
+TEST(sell, spmv_matches_csr) {
+    for (size_t n : {1, 7, 100, 333}) {
+        auto b = csr_mat<double>::from_entries(n, n, power_law(n));
+        owned_vec<double> x(n);
+        for (size_t i = 0; i < n; i++) x[i] = (i % 5) - 2.0;
+        auto want = b * x.as_const();
+        for (size_t sigma : {1, 8, 1000}) {
+            ASSERT_EQ(sell_mat<double>(b, sigma) * x.as_const(), want);
+            ASSERT_EQ((sell_mat<double, 3>(b, sigma) * x.as_const()), want);
+        }
+    }
+}
+
+TEST(sell, padding_ignores_non_finite_x0) {
+    // Row 0 never reads column 0 but is padded to the length of row 1 in its chunk.
+    auto b = csr_mat<double>::from_entries(2, 3, {{0, 1, 2.0}, {1, 0, 1.0}, {1, 1, 1.0},
+                                                  {1, 2, 1.0}});
+    owned_vec<double> x(3);
+    x[1] = 1; x[2] = 1;
+    for (double bad : {std::numeric_limits<double>::quiet_NaN(),
+                       std::numeric_limits<double>::infinity()}) {
+        x[0] = bad;
+        auto want = b * x.as_const();
+        auto y = sell_mat<double, 2>(b) * x.as_const();
+        ASSERT_EQ(y[0], 2.0);
+        ASSERT_EQ(y[0], want[0]);
+        ASSERT_FALSE(std::isfinite(y[1]));
+    }
+}
+
+TEST(sell, sorting_reduces_padding) {
+    auto b = csr_mat<double>::from_entries(512, 512, power_law(512));
+    ASSERT_LE(sell_mat<double>(b, 512).n_stored(), sell_mat<double>(b, 1).n_stored());
+}
+
+TEST(sell, spmv_of_strided_vector_with_empty_rows) {
+    auto a = sell_mat<int, 4>::from_entries(6, 3, {{0, 2, 1}, {4, 0, 2}, {4, 2, 3}});
+    owned_row_mat<int> xs(3, 2);
+    xs[0][1] = 5; xs[2][1] = 7;
+    auto y = a * xs.col(1).as_const();
+    ASSERT_EQ(y[0], 7);
+    ASSERT_EQ(y[1], 0);
+    ASSERT_EQ(y[4], 31);
+    owned_vec<int> bad(4);
+    ASSERT_THROW((void)(a * bad.as_const()), vec_len_mismatch);
+}
+// NOLINTEND
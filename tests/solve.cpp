@@ -0,0 +1,119 @@
+#include "solve.hxx"
+#include <gtest.h>
+
+// NOLINTBEGIN
+// 2D Poisson matrix on a k x k grid, plus a first-order convection term when asked to.
+static csr_mat<double> poisson(size_t k, double conv = 0) {
+    std::vector<coo_entry<double>> es;
+    for (size_t i = 0; i < k; i++) for (size_t j = 0; j < k; j++) {
+        size_t r = (i * k) + j;
+        es.push_back({r, r, 4.0});
+        if (i > 0)     es.push_back({r, r - k, -1.0 - conv});
+        if (i + 1 < k) es.push_back({r, r + k, -1.0 + conv});
+        if (j > 0)     es.push_back({r, r - 1, -1.0 - conv});
+        if (j + 1 < k) es.push_back({r, r + 1, -1.0 + conv});
+    }
+    return csr_mat<double>::from_entries(k * k, k * k, es);
+}
+
+static double resid(csr_mat<double> const& a, owned_vec<double> const& b, owned_vec<double> const& x) {
+    auto ax = a * x.as_const();
+    double rr = 0, bb = 0;
+    for (size_t i = 0; i < b.len(); i++) { rr += (b[i] - ax[i]) * (b[i] - ax[i]); bb += b[i] * b[i]; }
+    return std::sqrt(rr / bb);
+}
+
+static owned_vec<double> rhs(size_t n) {
+    owned_vec<double> b(n);
+    for (size_t i = 0; i < n; i++) b[i] = 1.0 + (i % 3);
+    return b;
+}
+
+TEST(solve, cg_with_each_preconditioner) {
+    auto a = poisson(20);
+    auto b = rhs(400);
+    krylov_solver<double> s({.tol = 1e-10});
+    owned_vec<double> x1(400), x2(400), x3(400);
+    auto r1 = s.cg(a, b, x1);
+    auto r2 = s.cg(a, b, x2, jacobi_precond<double>(a));
+    auto r3 = s.cg(a, b, x3, ilu0_precond<double>(a));
+    ASSERT_TRUE(r1.converged && r2.converged && r3.converged);
+    ASSERT_LT(r3.iters, r1.iters);
+    ASSERT_LT(resid(a, b, x1), 1e-9);
+    ASSERT_LT(resid(a, b, x2), 1e-9);
+    ASSERT_LT(resid(a, b, x3), 1e-9);
+}
+
+TEST(solve, bicgstab_nonsymmetric) {
+    auto a = poisson(15, 0.3);
+    auto b = rhs(225);
+    krylov_solver<double> s({.tol = 1e-10});
+    owned_vec<double> x1(225), x2(225);
+    ASSERT_TRUE(s.bicgstab(a, b, x1).converged);
+    ASSERT_TRUE(s.bicgstab(a, b, x2, ilu0_precond<double>(a)).converged);
+    ASSERT_LT(resid(a, b, x1), 1e-9);
+    ASSERT_LT(resid(a, b, x2), 1e-9);
+}
+
+TEST(solve, gmres_nonsymmetric_with_restarts) {
+    auto a = poisson(15, 0.3);
+    auto b = rhs(225);
+    krylov_solver<double> s({.tol = 1e-10, .max_iter = 2000, .restart = 10});
+    owned_vec<double> x1(225), x2(225);
+    auto r1 = s.gmres(a, b, x1);
+    ASSERT_TRUE(r1.converged);
+    ASSERT_GT(r1.iters, 10);
+    ASSERT_TRUE(s.gmres(a, b, x2, jacobi_precond<double>(a)).converged);
+    ASSERT_LT(resid(a, b, x1), 1e-9);
+    ASSERT_LT(resid(a, b, x2), 1e-9);
+}
+
+TEST(solve, dense_and_callable_operators) {
+    auto a = poisson(6);
+    auto d = a.to_dense<mat_maj::col>();
+    auto b = rhs(36);
+    krylov_solver<double> s({.tol = 1e-12});
+    owned_vec<double> x1(36), x2(36);
+    ASSERT_TRUE(s.cg(d, b, x1).converged);
+    auto op = [&](vec<double const, false> x, vec<double, false> y) { a.mul_vec_nocklen(x, y); };
+    ASSERT_TRUE(s.gmres(op, b, x2).converged);
+    for (size_t i = 0; i < 36; i++) ASSERT_NEAR(x1[i], x2[i], 1e-9);
+}
+
+TEST(solve, initial_guess_is_used) {
+    auto a = poisson(8);
+    auto b = rhs(64);
+    krylov_solver<double> s;
+    owned_vec<double> x(64);
+    ASSERT_TRUE(s.cg(a, b, x).converged);
+    ASSERT_EQ(s.cg(a, b, x).iters, 0);
+}
+
+TEST(solve, mismatched_sizes_fail) {
+    auto a = poisson(4);
+    owned_vec<double> b(16), x(15);
+    krylov_solver<double> s;
+    ASSERT_THROW(s.cg(a, b, x), vec_len_mismatch);
+    owned_vec<double> b2(15);
+    ASSERT_THROW(s.cg(a, b2, x), mat_size_mismatch);
+}
+
+TEST(solve, missing_diagonal_fails) {
+    auto a = csr_mat<double>::from_entries(2, 2, {{0, 1, 1.0}, {1, 0, 1.0}});
+    ASSERT_THROW(ilu0_precond<double> m(a), zero_pivot);
+    ASSERT_THROW(jacobi_precond<double> m(a), zero_pivot);
+}
+#if defined(MATRIX_PERF_COUNTERS)
+TEST(solve, profile_counts_work_per_iteration) {
+    auto a = poisson(10);
+    auto b = rhs(100);
+    krylov_solver<double> s;
+    owned_vec<double> x(100);
+    perf_registry::get().reset();
+    auto r = s.cg(a, b, x);
+    auto st = perf_registry::get().at("cg");
+    ASSERT_EQ(st.flops, r.iters * ((2 * a.nnz()) + (13 * 100)));
+    ASSERT_GT(st.bytes, r.iters * a.nnz() * sizeof(double));
+}
+#endif
+// NOLINTEND
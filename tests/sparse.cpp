@@ -0,0 +1,110 @@
+#include "sparse.hxx"
+#include <gtest.h>
+#include <cmath>
+#include <limits>
+
+// NOLINTBEGIN
+static owned_row_mat<int> banded(size_t n) {
+    owned_row_mat<int> d(n, n);
+    for (size_t i = 0; i < n; i++) {
+        d[i][i] = 2;
+        if (i + 3 < n) d[i][i + 3] = -1;
+        if (i % 7 == 0) d[i][0] = i + 1;
+    }
+    return d;
+}
+
+TEST(sparse, malformed_structure_fails) {
+    ASSERT_THROW(csr_mat<int>(2, 2, {0, 1}, {0}, {1}), bad_sparse_structure);
+    ASSERT_THROW(csr_mat<int>(2, 2, {0, 2, 2}, {1, 0}, {1, 1}), bad_sparse_structure);
+    ASSERT_THROW(csr_mat<int>(2, 2, {0, 1, 2}, {0, 2}, {1, 1}), bad_sparse_structure);
+}
+
+TEST(sparse, dense_round_trip) {
+    auto d = banded(20);
+    csr_mat<int> a(d.as_const());
+    csc_mat<int> b(d.as_const());
+    ASSERT_EQ(a.nnz(), b.nnz());
+    ASSERT_EQ(a.to_dense(), d);
+    ASSERT_EQ(b.to_dense<mat_maj::row>(), d);
+    ASSERT_EQ(a.at(7, 0), 8);
+    ASSERT_EQ(a.at(7, 1), 0);
+}
+
+TEST(sparse, entries_are_summed_and_sorted) {
+    auto a = csc_mat<int>::from_entries(3, 3, {{2, 1, 5}, {0, 1, 1}, {2, 1, 2}, {1, 0, 4}});
+    ASSERT_EQ(a.nnz(), 3);
+    ASSERT_EQ(a.at(2, 1), 7);
+    ASSERT_EQ(a.at(0, 1), 1);
+    ASSERT_EQ(a.at(1, 0), 4);
+    ASSERT_THROW((void)csr_mat<int>::from_entries(3, 3, {{3, 0, 1}}), mat_out_of_bounds);
+}
+
+TEST(sparse, storage_order_conversion) {
+    csr_mat<int> a(banded(15).as_const());
+    auto b = a.with_maj<mat_maj::col>();
+    ASSERT_EQ(b.to_dense(), a.to_dense<mat_maj::col>());
+    ASSERT_EQ(b.with_maj<mat_maj::row>().to_dense(), a.to_dense());
+}
+
+TEST(sparse, spmv_matches_dense) {
+    auto d = banded(50);
+    owned_vec<int> x(50);
+    for (size_t i = 0; i < 50; i++) x[i] = i % 4;
+    owned_vec<int> want(50);
+    for (size_t i = 0; i < 50; i++) want[i] = d.row(i).as_const() * x.as_const();
+    ASSERT_EQ(csr_mat<int>(d.as_const()) * x.as_const(), want);
+    ASSERT_EQ(csc_mat<int>(d.as_const()) * x.as_const(), want);
+}
+
+TEST(sparse, spmv_propagates_nan_in_both_orders) {
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    auto es = std::vector<coo_entry<double>> {{0, 0, 1.0}, {0, 1, nan}, {1, 1, 2.0}};
+    owned_vec<double> x(2);
+    x[0] = 1.0; // x[1] = 0 meets the stored NaN
+    auto yr = csr_mat<double>::from_entries(2, 2, es) * x.as_const();
+    auto yc = csc_mat<double>::from_entries(2, 2, es) * x.as_const();
+    ASSERT_TRUE(std::isnan(yr[0]));
+    ASSERT_TRUE(std::isnan(yc[0]));
+    ASSERT_EQ(yc[1], 0.0);
+}
+
+TEST(sparse, spmv_parallel_matches_serial) {
+    size_t n = 40000;
+    std::vector<coo_entry<double>> es;
+    for (size_t i = 0; i < n; i++) {
+        es.push_back({i, i, 4.0});
+        es.push_back({i, (i * 31) % n, 1.0});
+        if (i % 100 == 0) for (size_t j = 0; j < 500; j++) es.push_back({i, j, 0.5});
+    }
+    auto a = csr_mat<double>::from_entries(n, n, es);
+    auto b = a.with_maj<mat_maj::col>();
+    owned_vec<double> x(n);
+    for (size_t i = 0; i < n; i++) x[i] = (i % 9) * 0.25;
+    set_par_threads(1);
+    auto y1 = a * x.as_const(), y2 = b * x.as_const();
+    set_par_threads(4);
+    auto y3 = a * x.as_const(), y4 = b * x.as_const();
+    set_par_threads(0);
+    ASSERT_EQ(y1, y3);
+    ASSERT_EQ(y1, y2);
+    ASSERT_EQ(y2, y4);
+}
+
+TEST(sparse, spmv_with_wrong_length_fails) {
+    csr_mat<int> a(banded(5).as_const());
+    owned_vec<int> x(4);
+    ASSERT_THROW((void)(a * x.as_const()), vec_len_mismatch);
+}
+
+TEST(sparse, spmm_matches_dense) {
+    auto d = banded(12);
+    owned_row_mat<int> b(12, 3);
+    for (size_t i = 0; i < 12; i++) for (size_t j = 0; j < 3; j++) b[i][j] = i + j;
+    owned_row_mat<int> want(12, 3);
+    for (size_t i = 0; i < 12; i++) for (size_t j = 0; j < 3; j++)
+        for (size_t k = 0; k < 12; k++) want[i][j] += d[i][k] * b[k][j];
+    ASSERT_EQ(csr_mat<int>(d.as_const()) * b.as_const(), want);
+    ASSERT_EQ(csc_mat<int>(d.as_const()) * b.as_const(), want);
+}
+// NOLINTEND
@@ -0,0 +1,72 @@
+#include "spgemm.hxx"
+#include <gtest.h>
+
+// NOLINTBEGIN
+static std::vector<coo_entry<long>> scattered(size_t rows, size_t cols, size_t seed) {
+    std::vector<coo_entry<long>> es;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t k = 0; k < 3; k++) es.push_back({i, (i * seed + k * 7) % cols, long(k + 1)});
+        if (i == rows / 2) for (size_t j = 0; j < cols; j++) es.push_back({i, j, 1});
+    }
+    return es;
+}
+
+template<mat_maj maj>
+static void check_against_dense(size_t m, size_t k, size_t n) {
+    auto a = sparse_mat<long, maj>::from_entries(m, k, scattered(m, k, 5));
+    auto b = sparse_mat<long, maj>::from_entries(k, n, scattered(k, n, 11));
+    auto da = a.template to_dense<mat_maj::row>(), db = b.template to_dense<mat_maj::row>();
+    owned_row_mat<long> want(m, n);
+    for (size_t i = 0; i < m; i++) for (size_t j = 0; j < n; j++)
+        for (size_t l = 0; l < k; l++) want[i][j] += da[i][l] * db[l][j];
+    auto c = a * b;
+    ASSERT_EQ(c.n_rows(), m);
+    ASSERT_EQ(c.n_cols(), n);
+    ASSERT_EQ(c.template to_dense<mat_maj::row>(), want);
+    auto idx = c.indices(), ptr = c.offsets();
+    for (size_t i = 0; i < c.n_maj(); i++)
+        for (size_t p = ptr[i] + 1; p < ptr[i + 1]; p++) ASSERT_LT(idx[p - 1], idx[p]);
+}
+
+TEST(spgemm, csr_matches_dense) { check_against_dense<mat_maj::row>(40, 300, 25); }
+TEST(spgemm, csc_matches_dense) { check_against_dense<mat_maj::col>(40, 300, 25); }
+TEST(spgemm, hash_accumulator_matches_dense) { check_against_dense<mat_maj::row>(30, 40, 2000); }
+
+TEST(spgemm, hash_accumulator_with_strided_columns) {
+    size_t const k = 64, stride = 4096;
+    std::vector<coo_entry<long>> ea, eb;
+    for (size_t l = 0; l < k; l++) {
+        ea.push_back({0, l, long(l + 1)});
+        eb.push_back({l, l * stride, 2});
+        eb.push_back({l, (k - 1 - l) * stride, 1});
+    }
+    auto c = csr_mat<long>::from_entries(1, k, ea) * csr_mat<long>::from_entries(k, k * stride, eb);
+    ASSERT_EQ(c.nnz(), k);
+    for (size_t l = 0; l < k; l++) ASSERT_EQ(c.at(0, l * stride), long(2 * (l + 1) + (k - l)));
+}
+
+TEST(spgemm, mismatched_sizes_fail) {
+    csr_mat<long> a(3, 4), b(5, 3);
+    ASSERT_THROW((void)(a * b), mat_size_mismatch);
+}
+
+TEST(spgemm, cancellation_keeps_structure) {
+    auto a = csr_mat<long>::from_entries(1, 2, {{0, 0, 1}, {0, 1, 1}});
+    auto b = csr_mat<long>::from_entries(2, 1, {{0, 0, 1}, {1, 0, -1}});
+    auto c = a * b;
+    ASSERT_EQ(c.nnz(), 1);
+    ASSERT_EQ(c.at(0, 0), 0);
+}
+
+TEST(spgemm, parallel_matches_serial) {
+    auto a = csr_mat<long>::from_entries(20000, 20000, scattered(20000, 20000, 17));
+    set_par_threads(1);
+    auto c1 = a * a;
+    set_par_threads(4);
+    auto c2 = a * a;
+    set_par_threads(0);
+    ASSERT_EQ(c1.nnz(), c2.nnz());
+    ASSERT_TRUE(std::ranges::equal(c1.indices(), c2.indices()));
+    ASSERT_TRUE(std::ranges::equal(c1.values(), c2.values()));
+}
+// NOLINTEND
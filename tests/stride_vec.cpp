@@ -0,0 +1,63 @@
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include "stride_vec.hxx"
+#include <gtest.h>
+
+// NOLINTBEGIN
+TEST(stride_vec, converts_to_and_from_runtime_stride) {
+    owned_col_mat<int> m(3, 5);
+    for (size_t r = 0; r < 3; r++) for (size_t c = 0; c < 5; c++) m[r][c] = int((r * 10) + c);
+    stride_vec<int, 3> row(m[1]);
+    ASSERT_EQ(row.len(), 5);
+    ASSERT_EQ(row[4], 14);
+    vec<int, true> back = row;
+    ASSERT_TRUE(back == m[1]);
+    ASSERT_TRUE(row == m[1]);
+    ASSERT_THROW((stride_vec<int, 2>(m[1])), bad_vec_stride);
+    ASSERT_THROW((void)row[5], vec_out_of_bounds);
+}
+
+TEST(stride_vec, deinterleave_channels) {
+    owned_vec<float> px(12);
+    for (size_t i = 0; i < 12; i++) px[i] = float(i);
+    auto [r, g, b] = deinterleave<3>(px.as_ref());
+    ASSERT_EQ(r.len(), 4);
+    ASSERT_EQ(g[2], 7.0f);
+    r += b;
+    ASSERT_EQ(px[9], 9.0f + 11.0f);
+    g *= 2.0f;
+    ASSERT_EQ(px[4], 8.0f);
+    ASSERT_THROW((void)deinterleave<5>(px.as_ref()), vec_len_mismatch);
+}
+
+TEST(stride_vec, dot_matches_runtime_stride) {
+    owned_vec<double> a(2 * 301), b(3 * 301);
+    for (size_t i = 0; i < a.len(); i++) a[i] = 0.5 * double(i % 7);
+    for (size_t i = 0; i < b.len(); i++) b[i] = double(i % 5) - 2;
+    stride_vec<double const, 2> x(a.ptr(), 301);
+    stride_vec<double const, 3> y(b.ptr(), 301);
+    vec<double const, true> rx(a.ptr(), 301, 2), ry(b.ptr(), 301, 3);
+    double want = rx * ry;
+    ASSERT_DOUBLE_EQ(x * y, want);
+    ASSERT_DOUBLE_EQ(x * ry, want);
+    ASSERT_THROW(x * y.slice(0, 300), vec_len_mismatch);
+}
+
+TEST(stride_vec, copy_and_blas1) {
+    owned_vec<double> a(8), c(4);
+    for (size_t i = 0; i < 8; i++) a[i] = double(i);
+    auto [re, im] = deinterleave<2>(a.as_ref());
+    stride_vec<double, 1> cc(c.as_ref());
+    cc.copy_from(im);
+    ASSERT_TRUE(cc == im);
+    axpy(2.0, re, im);
+    ASSERT_EQ(a[3], 3.0 + (2 * 2.0));
+    axpby(1.0, cc, -1.0, im);
+    ASSERT_EQ(a[3], -4.0);
+    ASSERT_DOUBLE_EQ(asum(re), 0 + 2 + 4 + 6);
+    ASSERT_DOUBLE_EQ(asum(re, sum_mode::kahan), 0 + 2 + 4 + 6);
+    ASSERT_DOUBLE_EQ(asum(re, sum_mode::pairwise), 0 + 2 + 4 + 6);
+    ASSERT_DOUBLE_EQ(nrm2(stride_vec<double, 2>(a.ptr(), 2)), 2.0);
+    ASSERT_THROW(axpy(1.0, re.slice(0, 3), im), vec_len_mismatch);
+}
+// NOLINTEND
@@ -0,0 +1,72 @@
+#include "owned_mat.hxx"
+#include "owned_vec.hxx"
+#include "par.hxx"
+#include "trace.hxx"
+#include <gtest.h>
+#include <sstream>
+#include <thread>
+
+// NOLINTBEGIN
+static size_t count(std::string const& s, std::string const& what) {
+    size_t n = 0;
+    for (size_t p = s.find(what); p != std::string::npos; p = s.find(what, p + 1)) n++;
+    return n;
+}
+
+TEST(trace, scopes_become_complete_events) {
+    trace_registry::get().clear();
+    { trace_scope s("test.outer", 3, 4, 96); trace_scope t("test.inner", 1, 1, 8); }
+    std::thread([] { trace_scope s("test.worker", 5, 1, 40); }).join();
+    std::stringstream o;
+    trace_registry::get().write_json(o);
+    auto j = o.str();
+    ASSERT_EQ(count(j, "\"ph\": \"X\""), 3);
+    ASSERT_NE(j.find("\"name\": \"test.outer\""), std::string::npos);
+    ASSERT_NE(j.find("\"rows\": 3, \"cols\": 4, \"bytes\": 96"), std::string::npos);
+    ASSERT_NE(j.find("test.worker\", \"ph\": \"X\", \"pid\": 1, \"tid\": "), std::string::npos);
+}
+
+TEST(trace, full_ring_keeps_newest_events) {
+    trace_registry::get().clear();
+    for (size_t i = 0; i < trace_ring::cap + 10; i++) { trace_scope s("test.many", i, 0, 0); }
+    std::stringstream o;
+    trace_registry::get().write_json(o);
+    auto j = o.str();
+    ASSERT_EQ(count(j, "test.many"), trace_ring::cap);
+    ASSERT_EQ(j.find("\"rows\": 9,"), std::string::npos);
+    ASSERT_NE(j.find("\"rows\": 10,"), std::string::npos);
+}
+
+TEST(trace, exited_threads_return_their_rings) {
+    trace_registry::get().clear();
+    size_t old = par_threads();
+    set_par_threads(4);
+    for (size_t i = 0; i < 200; i++)
+        par_for(4, 1, [](size_t i0, size_t) { trace_scope s("test.par", i0, 0, 0); });
+    set_par_threads(old);
+    ASSERT_LE(trace_registry::get().size(), 8);
+    std::stringstream o;
+    trace_registry::get().write_json(o);
+    ASSERT_EQ(count(o.str(), "test.par"), 800); // events of exited threads are kept
+}
+
+#if defined(MATRIX_TRACE)
+TEST(trace, element_wise_ops_and_printing_are_traced) {
+    trace_registry::get().clear();
+    owned_vec<double> x(4), y(4);
+    owned_row_mat<double> a(2, 2), b(2, 2);
+    auto z = x + y;
+    z = x - y;
+    auto c = a + b;
+    c -= a;
+    std::stringstream out;
+    out << x.as_const() << c;
+    std::stringstream o;
+    trace_registry::get().write_json(o);
+    auto j = o.str();
+    for (char const* site : {"vec.add", "vec.sub", "mat.add", "mat.sub_assign", "vec.print",
+                             "mat.print"})
+        ASSERT_NE(j.find("\"name\": \"" + std::string(site) + '"'), std::string::npos) << site;
+}
+#endif
+// NOLINTEND
@@ -0,0 +1,117 @@
+#include "autotune.hxx"
+#include <gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+// NOLINTBEGIN
+TEST(tune, file_round_trips) {
+    tune_params p {.gemv_block = 512, .qr_block = 48, .dense_grain = 7, .sparse_grain = 9,
+                   .batch_grain = 11};
+    std::stringstream s;
+    write_tune_file(s, p);
+    ASSERT_EQ(parse_tune_file(s), p);
+}
+
+TEST(tune, parse_keeps_unnamed_and_malformed) {
+    std::stringstream s("# comment\nqr_block = 16  # narrow\nbogus = 3\ngemv_block = x\n"
+                        "dense_grain 5\nsparse_grain = 0\n");
+    tune_params base {.gemv_block = 1024};
+    tune_params p = parse_tune_file(s, base);
+    ASSERT_EQ(p.qr_block, 16);
+    ASSERT_EQ(p.gemv_block, 1024);
+    ASSERT_EQ(p.dense_grain, tune_params {}.dense_grain);
+    ASSERT_EQ(p.sparse_grain, tune_params {}.sparse_grain);
+}
+
+TEST(tune, reads_cache_sizes_from_sysfs_layout) {
+    auto dir = std::filesystem::temp_directory_path() / "matrix_tune_cache";
+    std::filesystem::remove_all(dir);
+    auto put = [&](int i, char const* level, char const* type, char const* size) {
+        auto d = dir / ("index" + std::to_string(i));
+        std::filesystem::create_directories(d);
+        std::ofstream(d / "level") << level << '\n';
+        std::ofstream(d / "type") << type << '\n';
+        std::ofstream(d / "size") << size << '\n';
+    };
+    put(0, "1", "Data", "32K");
+    put(1, "1", "Instruction", "64K");
+    put(2, "2", "Unified", "2048K");
+    put(3, "3", "Unified", "16M");
+    cache_sizes cs = read_cache_sizes(dir.string());
+    std::filesystem::remove_all(dir);
+    ASSERT_EQ(cs.l1d, 32 << 10);
+    ASSERT_EQ(cs.l2, 2 << 20);
+    ASSERT_EQ(cs.l3, 16 << 20);
+
+    tune_params p = heuristic_params(cs);
+    ASSERT_EQ(p.gemv_block, 2048);
+    ASSERT_EQ(p.qr_block, 64);
+    ASSERT_EQ(heuristic_params({}), tune_params {});
+}
+
+TEST(tune, kernels_follow_tuned_params) {
+    tune_params old = tuned();
+    set_tuned({.gemv_block = 3, .qr_block = 2, .dense_grain = 1, .sparse_grain = 1,
+               .batch_grain = 1});
+    owned_row_mat<double> a(7, 5);
+    owned_vec<double> x(5), y(7);
+    for (size_t i = 0; i < 7; i++) for (size_t j = 0; j < 5; j++) a[i][j] = double(i + j);
+    for (size_t j = 0; j < 5; j++) x[j] = 1;
+    gemv(1.0, a.as_const(), x.as_const(), 0.0, y.as_ref());
+    for (size_t i = 0; i < 7; i++) ASSERT_DOUBLE_EQ(y[i], double((5 * i) + 10));
+    set_tuned(old);
+}
+
+TEST(tune, zero_fields_keep_their_values) {
+    tune_params old = tuned();
+    set_tuned({.gemv_block = 0, .qr_block = 0, .dense_grain = 0, .sparse_grain = 0,
+               .batch_grain = 7});
+    ASSERT_EQ(tuned().sparse_grain, old.sparse_grain);
+    ASSERT_EQ(tuned().dense_grain, old.dense_grain);
+    ASSERT_EQ(tuned().batch_grain, 7);
+    auto a = csc_mat<double>::from_entries(100, 100, {{3, 4, 2.0}, {50, 60, 1.0}});
+    owned_vec<double> x(100);
+    x[4] = 1;
+    ASSERT_EQ((a * x.as_const())[3], 2.0);
+    set_tuned(old);
+}
+
+TEST(tune, readers_see_whole_snapshots) {
+    tune_params old = tuned();
+    std::atomic<bool> stop {false}, torn {false};
+    std::thread reader([&] {
+        while (!stop.load()) {
+            tune_params const& p = tuned();
+            if (p.dense_grain != 2 * p.sparse_grain) torn = true;
+        }
+    });
+    for (size_t i = 1; i <= 2000; i++) {
+        tune_params p = old;
+        p.sparse_grain = i;
+        p.dense_grain  = 2 * i;
+        set_tuned(p);
+    }
+    stop = true;
+    reader.join();
+    ASSERT_FALSE(torn.load());
+    ASSERT_EQ(tuned().sparse_grain, 2000);
+    set_tuned(old);
+    ASSERT_EQ(tuned(), old);
+}
+
+TEST(tune, autotune_picks_candidates_and_saves) {
+    tune_params old = tuned();
+    tune_params p = autotune({.n = 64, .reps = 1});
+    ASSERT_EQ(tuned(), p);
+    ASSERT_GE(p.gemv_block, 256);
+    ASSERT_LE(p.qr_block, 128);
+    auto path = std::filesystem::temp_directory_path() / "matrix_tune_dir" / "tune.conf";
+    ASSERT_TRUE(save_tune_file(p, path.string()));
+    std::ifstream f(path);
+    ASSERT_EQ(parse_tune_file(f), p);
+    std::filesystem::remove_all(path.parent_path());
+    set_tuned(old);
+}
+// NOLINTEND
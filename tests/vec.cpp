@@ -1,3 +1,4 @@
+#include "owned_mat.hxx"
 #include "owned_vec.hxx"
 #include <gtest.h>
 
@@ -152,4 +153,63 @@ TEST(vec, dot_with_different_size_fails) {
     owned_vec<int> v1(3), v2(4);
     ASSERT_ANY_THROW(v1 * v2);
 }
+
+// Rows of a row-major matrix are contiguous and its columns are strided;
+// a column-major matrix holding the same values has it the other way round.
+static owned_row_mat<int> strided_fixture() {
+    owned_row_mat<int> m(70, 70);
+    for (size_t i = 0; i < 70; i++) for (size_t j = 0; j < 70; j++) m[i][j] = (i * 3) + (j * 5);
+    return m;
+}
+static owned_col_mat<int> same_values_col_major(owned_row_mat<int> const& r) {
+    owned_col_mat<int> c(70, 70);
+    for (size_t i = 0; i < 70; i++) for (size_t j = 0; j < 70; j++) c[i][j] = r[i][j];
+    return c;
+}
+static int naive_dot(owned_row_mat<int> const& m, size_t r, size_t c) {
+    int s = 0;
+    for (size_t k = 0; k < 70; k++) s += m[r][k] * m[k][c];
+    return s;
+}
+
+TEST(vec, dot_for_every_stride_combination) {
+    auto r = strided_fixture();
+    auto c = same_values_col_major(r);
+    int want = naive_dot(r, 2, 3);
+    ASSERT_EQ(r.row(2).as_const() * c.col(3).as_const(), want); // contiguous . contiguous
+    ASSERT_EQ(r.row(2).as_const() * r.col(3).as_const(), want); // contiguous . strided
+    ASSERT_EQ(c.row(2).as_const() * c.col(3).as_const(), want); // strided . contiguous
+    ASSERT_EQ(c.row(2).as_const() * r.col(3).as_const(), want); // strided . strided
+}
+
+TEST(vec, equality_for_every_stride_combination) {
+    auto r = strided_fixture();
+    auto c = same_values_col_major(r);
+    owned_row_mat<int> r2 {r};
+    owned_vec<int> row {r.row(4)};
+    ASSERT_EQ(r.row(4), row);        // contiguous == contiguous
+    ASSERT_EQ(r.row(4), c.row(4));   // contiguous == strided
+    ASSERT_EQ(c.row(4), r.row(4));   // strided == contiguous
+    ASSERT_EQ(r.col(4), r2.col(4));  // strided == strided
+    ASSERT_NE(r.row(4), c.row(5));
+    ASSERT_NE(r.col(4), r2.col(5));
+}
+
+TEST(vec, inequality_found_anywhere) {
+    owned_vec<int> a(150), b(150);
+    for (size_t i : {0, 10, 63, 64, 127, 128, 149}) {
+        b[i] = 1;
+        ASSERT_NE(a, b);
+        b[i] = 0;
+        ASSERT_EQ(a, b);
+    }
+}
+
+TEST(vec, scalar_ops_respect_stride) {
+    owned_vec<int> v(6);
+    vec<int, true> odd(v.ptr() + 1, 3, 2);
+    odd += 3;
+    odd *= 2;
+    for (size_t i = 0; i < 6; i++) ASSERT_EQ(v[i], i % 2 ? 6 : 0);
+}
 // NOLINTEND